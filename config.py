@@ -61,6 +61,7 @@ def get_doc_classes():
 
         "TerrainJob",
         "TerrainTerrainJob",
+        "TerrainGenerateJob",
         "TerrainLightJob",
         "TerrainPropJob",
 
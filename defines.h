@@ -52,6 +52,7 @@
 #define REAL FLOAT
 #define POOL_STRING_ARRAY PACKED_STRING_ARRAY
 #define POOL_BYTE_ARRAY PACKED_BYTE_ARRAY
+#define POOL_VECTOR3_ARRAY PACKED_VECTOR3_ARRAY
 #define Spatial Node3D
 #define SpatialMaterial StandardMaterial3D
 #define PoolVector3Array PackedVector3Array
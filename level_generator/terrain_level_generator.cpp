@@ -30,6 +30,12 @@ void TerrainLevelGenerator::generate_chunk(Ref<TerrainChunk> chunk) {
 	}
 }
 
+bool TerrainLevelGenerator::is_thread_safe() const {
+	ScriptInstance *si = get_script_instance();
+
+	return !(si && si->has_method("_generate_chunk"));
+}
+
 TerrainLevelGenerator::TerrainLevelGenerator() {
 }
 
@@ -40,4 +46,5 @@ void TerrainLevelGenerator::_bind_methods() {
 	//BIND_VMETHOD(MethodInfo("_generate_chunk", PropertyInfo(Variant::OBJECT, "chunk", PROPERTY_HINT_RESOURCE_TYPE, "TerrainChunk")));
 
 	ClassDB::bind_method(D_METHOD("generate_chunk", "chunk"), &TerrainLevelGenerator::generate_chunk);
+	ClassDB::bind_method(D_METHOD("is_thread_safe"), &TerrainLevelGenerator::is_thread_safe);
 }
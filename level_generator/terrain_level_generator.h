@@ -39,6 +39,11 @@ class TerrainLevelGenerator : public Resource {
 public:
 	void generate_chunk(Ref<TerrainChunk> chunk);
 
+	//Native generators are run from worker threads (TerrainGenerateJob), so their
+	//_generate_chunk must only write into the chunk it gets, and only read the generator's own data.
+	//Return false from an override if that's not possible. Script generators always run on the main thread.
+	virtual bool is_thread_safe() const;
+
 	TerrainLevelGenerator();
 	~TerrainLevelGenerator();
 
@@ -152,6 +152,14 @@ void TerrainLibrary::set_initialized(const bool value) {
 	_initialized = value;
 }
 
+//part of the mesh cache keys, bump it when the library changes in a way that affects the meshes
+int TerrainLibrary::get_revision() const {
+	return _revision;
+}
+void TerrainLibrary::set_revision(const int value) {
+	_revision = value;
+}
+
 bool TerrainLibrary::supports_caching() {
 	RETURN_CALLD(bool, false, _supports_caching);
 }
@@ -461,6 +469,7 @@ void TerrainLibrary::setup_material_albedo(int material_index, Ref<Texture> text
 
 TerrainLibrary::TerrainLibrary() {
 	_initialized = false;
+	_revision = 0;
 }
 
 TerrainLibrary::~TerrainLibrary() {
@@ -488,6 +497,10 @@ void TerrainLibrary::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_initialized", "value"), &TerrainLibrary::set_initialized);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "initialized", PROPERTY_HINT_NONE, "", 0), "set_initialized", "get_initialized");
 
+	ClassDB::bind_method(D_METHOD("get_revision"), &TerrainLibrary::get_revision);
+	ClassDB::bind_method(D_METHOD("set_revision", "value"), &TerrainLibrary::set_revision);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "revision"), "set_revision", "get_revision");
+
 #if VERSION_MAJOR < 4
 	//BIND_VMETHOD(MethodInfo(PropertyInfo(Variant::BOOL, "ret"), "_supports_caching"));
 #else
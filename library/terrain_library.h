@@ -85,6 +85,9 @@ public:
 	bool get_initialized() const;
 	void set_initialized(const bool value);
 
+	int get_revision() const;
+	void set_revision(const int value);
+
 	bool supports_caching();
 	virtual bool _supports_caching();
 
@@ -200,6 +203,7 @@ protected:
 	static void _bind_methods();
 
 	bool _initialized;
+	int _revision;
 	Vector<Ref<Material>> _materials;
 	Vector<Ref<Material>> _liquid_materials;
 	Vector<Ref<Material>> _prop_materials;
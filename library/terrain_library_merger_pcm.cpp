@@ -47,37 +47,50 @@ bool TerrainLibraryMergerPCM::_supports_caching() {
 }
 
 void TerrainLibraryMergerPCM::_material_cache_get_key(Ref<TerrainChunk> chunk) {
-	uint8_t *ch = chunk->channel_get(TerrainChunkDefault::DEFAULT_CHANNEL_TYPE);
+	Vector<uint8_t> surfaces;
 
-	if (!ch) {
-		chunk->material_cache_key_set(0);
-		chunk->material_cache_key_has_set(false);
+	//uniform and palette encoded channels already know their ids
+	PoolByteArray palette = chunk->channel_get_palette(TerrainChunkDefault::DEFAULT_CHANNEL_TYPE);
 
-		return;
-	}
-
-	Vector<uint8_t> surfaces;
+	if (palette.size() > 0) {
+		for (int i = 0; i < palette.size(); ++i) {
+			uint8_t v = palette[i];
 
-	uint32_t size = chunk->get_data_size();
+			if (v != 0) {
+				surfaces.push_back(v);
+			}
+		}
+	} else {
+		const uint8_t *ch = chunk->channel_get_read(TerrainChunkDefault::DEFAULT_CHANNEL_TYPE);
 
-	for (uint32_t i = 0; i < size; ++i) {
-		uint8_t v = ch[i];
+		if (!ch) {
+			chunk->material_cache_key_set(0);
+			chunk->material_cache_key_has_set(false);
 
-		if (v == 0) {
-			continue;
+			return;
 		}
 
-		int ssize = surfaces.size();
-		bool found = false;
-		for (uint8_t j = 0; j < ssize; ++j) {
-			if (surfaces[j] == v) {
-				found = true;
-				break;
+		uint32_t size = chunk->get_data_size();
+
+		for (uint32_t i = 0; i < size; ++i) {
+			uint8_t v = ch[i];
+
+			if (v == 0) {
+				continue;
 			}
-		}
 
-		if (!found) {
-			surfaces.push_back(v);
+			int ssize = surfaces.size();
+			bool found = false;
+			for (uint8_t j = 0; j < ssize; ++j) {
+				if (surfaces[j] == v) {
+					found = true;
+					break;
+				}
+			}
+
+			if (!found) {
+				surfaces.push_back(v);
+			}
 		}
 	}
 
@@ -216,37 +229,50 @@ void TerrainLibraryMergerPCM::_material_cache_unref(const int key) {
 
 //Liquids
 void TerrainLibraryMergerPCM::_liquid_material_cache_get_key(Ref<TerrainChunk> chunk) {
-	uint8_t *ch = chunk->channel_get(TerrainChunkDefault::DEFAULT_CHANNEL_LIQUID_TYPE);
+	Vector<uint8_t> surfaces;
 
-	if (!ch) {
-		chunk->liquid_material_cache_key_set(0);
-		chunk->liquid_material_cache_key_has_set(false);
+	//uniform and palette encoded channels already know their ids
+	PoolByteArray palette = chunk->channel_get_palette(TerrainChunkDefault::DEFAULT_CHANNEL_LIQUID_TYPE);
 
-		return;
-	}
-
-	Vector<uint8_t> surfaces;
+	if (palette.size() > 0) {
+		for (int i = 0; i < palette.size(); ++i) {
+			uint8_t v = palette[i];
 
-	uint32_t size = chunk->get_data_size();
+			if (v != 0) {
+				surfaces.push_back(v);
+			}
+		}
+	} else {
+		const uint8_t *ch = chunk->channel_get_read(TerrainChunkDefault::DEFAULT_CHANNEL_LIQUID_TYPE);
 
-	for (uint32_t i = 0; i < size; ++i) {
-		uint8_t v = ch[i];
+		if (!ch) {
+			chunk->liquid_material_cache_key_set(0);
+			chunk->liquid_material_cache_key_has_set(false);
 
-		if (v == 0) {
-			continue;
+			return;
 		}
 
-		int ssize = surfaces.size();
-		bool found = false;
-		for (uint8_t j = 0; j < ssize; ++j) {
-			if (surfaces[j] == v) {
-				found = true;
-				break;
+		uint32_t size = chunk->get_data_size();
+
+		for (uint32_t i = 0; i < size; ++i) {
+			uint8_t v = ch[i];
+
+			if (v == 0) {
+				continue;
 			}
-		}
 
-		if (!found) {
-			surfaces.push_back(v);
+			int ssize = surfaces.size();
+			bool found = false;
+			for (uint8_t j = 0; j < ssize; ++j) {
+				if (surfaces[j] == v) {
+					found = true;
+					break;
+				}
+			}
+
+			if (!found) {
+				surfaces.push_back(v);
+			}
 		}
 	}
 
@@ -37,7 +37,47 @@ bool TerrainMaterialCache::get_initialized() {
 	return _initialized;
 }
 void TerrainMaterialCache::set_initialized(const bool value) {
+	Vector<InitializationCallback> callbacks;
+
+	_initialization_mutex.lock();
+
 	_initialized = value;
+
+	if (value) {
+		callbacks = _initialization_callbacks;
+		_initialization_callbacks.clear();
+	}
+
+	_initialization_mutex.unlock();
+
+	//called outside of the lock, as callbacks usually queue work that can end up here again
+	for (int i = 0; i < callbacks.size(); ++i) {
+		Object *obj = ObjectDB::get_instance(callbacks[i].object);
+
+		if (obj) {
+			obj->call(callbacks[i].method);
+		}
+	}
+}
+
+//Returns true if the cache is initialized. Otherwise the method gets called (from the thread that finishes
+//the initialization) when it's done, so the caller can park instead of waiting.
+bool TerrainMaterialCache::initialization_wait(Object *p_object, const StringName &p_method) {
+	ERR_FAIL_COND_V(!p_object, _initialized);
+
+	MutexLock lock(_initialization_mutex);
+
+	if (_initialized) {
+		return true;
+	}
+
+	InitializationCallback cb;
+	cb.object = p_object->get_instance_id();
+	cb.method = p_method;
+
+	_initialization_callbacks.push_back(cb);
+
+	return false;
 }
 
 int TerrainMaterialCache::get_ref_count() {
@@ -252,7 +292,7 @@ void TerrainMaterialCache::prop_remove_textures(const Ref<PropData> &prop) {
 #endif
 
 void TerrainMaterialCache::refresh_rects() {
-	_initialized = true;
+	set_initialized(true);
 }
 
 void TerrainMaterialCache::setup_material_albedo(Ref<Texture> texture) {
@@ -279,6 +319,7 @@ void TerrainMaterialCache::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_initialized"), &TerrainMaterialCache::get_initialized);
 	ClassDB::bind_method(D_METHOD("set_initialized", "value"), &TerrainMaterialCache::set_initialized);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "initialized"), "set_initialized", "get_initialized");
+	ClassDB::bind_method(D_METHOD("initialization_wait", "object", "method"), &TerrainMaterialCache::initialization_wait);
 
 	ClassDB::bind_method(D_METHOD("get_ref_count"), &TerrainMaterialCache::get_ref_count);
 	ClassDB::bind_method(D_METHOD("set_ref_count", "value"), &TerrainMaterialCache::set_ref_count);
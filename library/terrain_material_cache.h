@@ -36,6 +36,7 @@ SOFTWARE.
 #endif
 
 #include "core/math/rect2.h"
+#include "core/os/mutex.h"
 #include "scene/resources/material.h"
 
 #include "terrain_library.h"
@@ -51,6 +52,8 @@ public:
 	bool get_initialized();
 	void set_initialized(const bool value);
 
+	bool initialization_wait(Object *p_object, const StringName &p_method);
+
 	int get_ref_count();
 	void set_ref_count(const int value);
 	void inc_ref_count();
@@ -104,7 +107,14 @@ public:
 protected:
 	static void _bind_methods();
 
+	struct InitializationCallback {
+		ObjectID object;
+		StringName method;
+	};
+
 	bool _initialized;
+	Mutex _initialization_mutex;
+	Vector<InitializationCallback> _initialization_callbacks;
 
 	Vector<Ref<TerrainSurface>> _surfaces;
 	Vector<Ref<Material>> _materials;
@@ -154,7 +154,7 @@ void TerrainMaterialCachePCM::refresh_rects() {
 		}
 	}
 
-	_initialized = true;
+	set_initialized(true);
 }
 
 void TerrainMaterialCachePCM::_setup_material_albedo(Ref<Texture> texture) {
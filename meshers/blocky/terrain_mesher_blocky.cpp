@@ -60,21 +60,23 @@ void TerrainMesherBlocky::add_chunk_normal(Ref<TerrainChunkDefault> chunk) {
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -84,15 +86,15 @@ void TerrainMesherBlocky::add_chunk_normal(Ref<TerrainChunkDefault> chunk) {
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
@@ -110,6 +112,10 @@ void TerrainMesherBlocky::add_chunk_normal(Ref<TerrainChunkDefault> chunk) {
 	int margin_start = chunk->get_margin_start();
 	//z_size + margin_start is fine, x, and z are in data space.
 	for (int z = margin_start; z < z_size + margin_start; ++z) {
+		if (is_cancelled()) {
+			return;
+		}
+
 		for (int x = margin_start; x < x_size + margin_start; ++x) {
 			int indexes[4] = {
 				chunk->get_data_index(x + 1, z),
@@ -223,27 +229,33 @@ void TerrainMesherBlocky::add_chunk_lod(Ref<TerrainChunkDefault> chunk) {
 	create_margin_xmax(chunk);
 	create_margin_corners(chunk);
 
+	if (is_cancelled()) {
+		return;
+	}
+
 	int x_size = chunk->get_size_x();
 	int z_size = chunk->get_size_z();
 	float world_height = chunk->get_world_height();
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -253,15 +265,15 @@ void TerrainMesherBlocky::add_chunk_lod(Ref<TerrainChunkDefault> chunk) {
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
@@ -283,6 +295,10 @@ void TerrainMesherBlocky::add_chunk_lod(Ref<TerrainChunkDefault> chunk) {
 	int margin_start = chunk->get_margin_start();
 	//z_size + margin_start is fine, x, and z are in data space.
 	for (int z = lod_skip; z < z_size + margin_start - lod_skip; z += lod_skip) {
+		if (is_cancelled()) {
+			return;
+		}
+
 		for (int x = lod_skip; x < x_size + margin_start - lod_skip; x += lod_skip) {
 			int indexes[4] = {
 				chunk->get_data_index(x + lod_skip, z),
@@ -396,21 +412,23 @@ void TerrainMesherBlocky::create_margin_zmin(Ref<TerrainChunkDefault> chunk) {
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -420,15 +438,15 @@ void TerrainMesherBlocky::create_margin_zmin(Ref<TerrainChunkDefault> chunk) {
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
@@ -576,21 +594,23 @@ void TerrainMesherBlocky::create_margin_zmax(Ref<TerrainChunkDefault> chunk) {
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -600,15 +620,15 @@ void TerrainMesherBlocky::create_margin_zmax(Ref<TerrainChunkDefault> chunk) {
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
@@ -754,21 +774,23 @@ void TerrainMesherBlocky::create_margin_xmin(Ref<TerrainChunkDefault> chunk) {
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -778,15 +800,15 @@ void TerrainMesherBlocky::create_margin_xmin(Ref<TerrainChunkDefault> chunk) {
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
@@ -932,21 +954,23 @@ void TerrainMesherBlocky::create_margin_xmax(Ref<TerrainChunkDefault> chunk) {
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -956,15 +980,15 @@ void TerrainMesherBlocky::create_margin_xmax(Ref<TerrainChunkDefault> chunk) {
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
@@ -1113,21 +1137,23 @@ void TerrainMesherBlocky::create_face(Ref<TerrainChunkDefault> chunk, int dataxm
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
 
 	if (!channel_type)
 		return;
 
-	uint8_t *channel_isolevel = chunk->channel_get(_channel_index_isolevel);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
 
 	if (!channel_isolevel)
 		return;
 
-	uint8_t *channel_color_r = NULL;
-	uint8_t *channel_color_g = NULL;
-	uint8_t *channel_color_b = NULL;
-	uint8_t *channel_ao = NULL;
-	uint8_t *channel_rao = NULL;
+	const uint8_t *channel_color_r = NULL;
+	const uint8_t *channel_color_g = NULL;
+	const uint8_t *channel_color_b = NULL;
+	const uint8_t *channel_ao = NULL;
+	const uint8_t *channel_rao = NULL;
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 	Color light[4]{ Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1), Color(1, 1, 1) };
@@ -1137,15 +1163,15 @@ void TerrainMesherBlocky::create_face(Ref<TerrainChunkDefault> chunk, int dataxm
 	bool use_rao = (get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_RAO) != 0;
 
 	if (use_lighting) {
-		channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-		channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-		channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+		channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+		channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+		channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
 
 		if (use_ao)
-			channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+			channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
 
 		if (use_rao)
-			channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+			channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
 	Ref<TerrainMaterialCache> mcache;
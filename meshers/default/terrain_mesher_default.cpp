@@ -51,11 +51,11 @@ void TerrainMesherDefault::_bake_colors(Ref<TerrainChunk> chunk) {
 	if (_vertices.size() == 0)
 		return;
 
-	uint8_t *channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-	uint8_t *channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-	uint8_t *channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
-	uint8_t *channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
-	uint8_t *channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+	const uint8_t *channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+	const uint8_t *channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+	const uint8_t *channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+	const uint8_t *channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+	const uint8_t *channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 
@@ -112,11 +112,11 @@ void TerrainMesherDefault::_bake_liquid_colors(Ref<TerrainChunk> chunk) {
 	if (_vertices.size() == 0)
 		return;
 
-	uint8_t *channel_color_r = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
-	uint8_t *channel_color_g = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
-	uint8_t *channel_color_b = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
-	uint8_t *channel_ao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
-	uint8_t *channel_rao = chunk->channel_get_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
+	const uint8_t *channel_color_r = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R);
+	const uint8_t *channel_color_g = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G);
+	const uint8_t *channel_color_b = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B);
+	const uint8_t *channel_ao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_AO);
+	const uint8_t *channel_rao = chunk->channel_get_read_valid(TerrainChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 
@@ -168,11 +168,39 @@ void TerrainMesher::set_is_liquid_mesher(const bool value) {
 	_is_liquid_mesher = value;
 }
 
+//set from other threads when the build gets cancelled, long loops check it and bail out early
+//reset() leaves it alone, jobs clear it when they start
+bool TerrainMesher::is_cancelled() const {
+	return _cancelled.is_set();
+}
+void TerrainMesher::set_cancelled(const bool value) {
+	_cancelled.set_to(value);
+}
+
+//copies every stored property (library, lod index, build flags etc. in subclasses), but not the mesh data
+void TerrainMesher::copy_settings_from(const Ref<TerrainMesher> &mesher) {
+	ERR_FAIL_COND(!mesher.is_valid());
+	ERR_FAIL_COND(mesher->get_class_name() != get_class_name());
+
+	List<PropertyInfo> properties;
+	mesher->get_property_list(&properties);
+
+	for (List<PropertyInfo>::Element *E = properties.front(); E; E = E->next()) {
+		const PropertyInfo &p = E->get();
+
+		if ((p.usage & PROPERTY_USAGE_STORAGE) == 0 || p.name == "script") {
+			continue;
+		}
+
+		set(p.name, mesher->get(p.name));
+	}
+}
+
 Array TerrainMesher::build_mesh() {
 	Array a;
 	a.resize(VisualServer::ARRAY_MAX);
 
-	if (_vertices.size() == 0) {
+	if (_vertices.size() == 0 || is_cancelled()) {
 		//Nothing to do
 		return a;
 	}
@@ -203,6 +231,10 @@ Array TerrainMesher::build_mesh() {
 		generate_normals();
 	}
 
+	if (is_cancelled()) {
+		return a;
+	}
+
 	{
 		PoolVector<Vector3> array;
 		array.resize(_vertices.size());
@@ -288,6 +320,10 @@ Array TerrainMesher::build_mesh() {
 		a[VisualServer::ARRAY_TEX_UV2] = array;
 	}
 
+	if (is_cancelled()) {
+		return a;
+	}
+
 	if (_indices.size() > 0) {
 		PoolVector<int> array;
 		array.resize(_indices.size());
@@ -324,6 +360,10 @@ void TerrainMesher::build_mesh_into(RID mesh) {
 
 	Array arr = build_mesh();
 
+	if (is_cancelled()) {
+		return;
+	}
+
 	VS::get_singleton()->mesh_add_surface_from_arrays(mesh, VisualServer::PRIMITIVE_TRIANGLES, arr);
 
 	if (_material.is_valid())
@@ -615,13 +655,17 @@ void TerrainMesher::bake_liquid_colors(Ref<TerrainChunk> chunk) {
 PoolVector<Vector3> TerrainMesher::build_collider() const {
 	PoolVector<Vector3> face_points;
 
-	if (_vertices.size() == 0)
+	if (_vertices.size() == 0 || is_cancelled())
 		return face_points;
 
 	if (_indices.size() == 0) {
 		int len = (_vertices.size() / 4);
 
 		for (int i = 0; i < len; ++i) {
+			if ((i & 1023) == 0 && is_cancelled()) {
+				return PoolVector<Vector3>();
+			}
+
 			face_points.push_back(_vertices.get(i * 4).vertex);
 			face_points.push_back(_vertices.get((i * 4) + 2).vertex);
 			face_points.push_back(_vertices.get((i * 4) + 1).vertex);
@@ -636,12 +680,119 @@ PoolVector<Vector3> TerrainMesher::build_collider() const {
 
 	face_points.resize(_indices.size());
 	for (int i = 0; i < face_points.size(); i++) {
+		if ((i & 1023) == 0 && is_cancelled()) {
+			return PoolVector<Vector3>();
+		}
+
 		face_points.set(i, _vertices.get(_indices.get(i)).vertex);
 	}
 
 	return face_points;
 }
 
+//builds the data of a heightmap shape straight from the type and isolevel channels
+//returns an empty Dictionary if the chunk has holes, as heightmap shapes can't have them
+Dictionary TerrainMesher::build_heightmap_collider(Ref<TerrainChunk> chunk) const {
+	ERR_FAIL_COND_V(!chunk.is_valid(), Dictionary());
+
+	Vector<uint8_t> type_data;
+	const uint8_t *channel_type = chunk->channel_decode(_channel_index_type, type_data);
+	Vector<uint8_t> isolevel_data;
+	const uint8_t *channel_isolevel = chunk->channel_decode(_channel_index_isolevel, isolevel_data);
+
+	if (!channel_type || !channel_isolevel || is_cancelled())
+		return Dictionary();
+
+	int x_size = chunk->get_size_x();
+	int z_size = chunk->get_size_z();
+	int margin_start = chunk->get_margin_start();
+	float world_height = chunk->get_world_height();
+
+	//lower collider lods skip data points, heights are scaled down so the shape can be scaled uniformly
+	int step = get_heightmap_collider_step(chunk);
+
+	x_size /= step;
+	z_size /= step;
+	world_height /= step;
+
+	int width = x_size + 1;
+	int depth = z_size + 1;
+
+	PoolRealArray heights;
+	heights.resize(width * depth);
+
+#if !GODOT4
+	PoolRealArray::Write w = heights.write();
+#endif
+
+	float min_height = world_height;
+	float max_height = 0;
+
+	for (int z = 0; z < depth; ++z) {
+		for (int x = 0; x < width; ++x) {
+			int dx = x * step + margin_start;
+			int dz = z * step + margin_start;
+
+			//same as the blocky mesher, a quad is skipped if the type of its x + 1 corner is 0
+			if (x < x_size && z < z_size) {
+				for (int sz = 0; sz < step; ++sz) {
+					for (int sx = 0; sx < step; ++sx) {
+						if (channel_type[chunk->get_data_index(dx + sx + 1, dz + sz)] == 0) {
+							return Dictionary();
+						}
+					}
+				}
+			}
+
+			float h = channel_isolevel[chunk->get_data_index(dx, dz)] / 255.0 * world_height;
+
+			min_height = MIN(min_height, h);
+			max_height = MAX(max_height, h);
+
+#if !GODOT4
+			w[z * width + x] = h;
+#else
+			heights.set(z * width + x, h);
+#endif
+		}
+	}
+
+#if !GODOT4
+	w.release();
+#endif
+
+	Dictionary d;
+	d["width"] = width;
+	d["depth"] = depth;
+	d["heights"] = heights;
+	d["min_height"] = min_height;
+	d["max_height"] = max_height;
+
+	return d;
+}
+
+//heightmap shapes are centered, and their cells are 1 unit wide
+Transform TerrainMesher::get_heightmap_collider_transform(Ref<TerrainChunk> chunk) const {
+	ERR_FAIL_COND_V(!chunk.is_valid(), Transform());
+
+	float scale = _voxel_scale * get_heightmap_collider_step(chunk);
+
+	Vector3 center((chunk->get_margin_start() + chunk->get_size_x() * 0.5) * _voxel_scale, 0, (chunk->get_margin_start() + chunk->get_size_z() * 0.5) * _voxel_scale);
+
+	return Transform(Basis().scaled(Vector3(scale, scale, scale)), center);
+}
+
+//the chunk's size has to be divisible by it
+int TerrainMesher::get_heightmap_collider_step(Ref<TerrainChunk> chunk) const {
+	int step = 1 << CLAMP(chunk->get_collider_lod_level(), 0, 4);
+
+	while (step > 1 && (chunk->get_size_x() % step != 0 || chunk->get_size_z() % step != 0)) {
+		step >>= 1;
+	}
+
+	return step;
+}
+
 void TerrainMesher::bake_lights(MeshInstance *node, Vector<Ref<TerrainLight>> &lights) {
 	ERR_FAIL_COND(node == NULL);
 
@@ -1087,6 +1238,13 @@ void TerrainMesher::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("build_mesh"), &TerrainMesher::build_mesh);
 	ClassDB::bind_method(D_METHOD("build_mesh_into", "mesh_rid"), &TerrainMesher::build_mesh_into);
 	ClassDB::bind_method(D_METHOD("build_collider"), &TerrainMesher::build_collider);
+	ClassDB::bind_method(D_METHOD("build_heightmap_collider", "chunk"), &TerrainMesher::build_heightmap_collider);
+	ClassDB::bind_method(D_METHOD("get_heightmap_collider_transform", "chunk"), &TerrainMesher::get_heightmap_collider_transform);
+
+	ClassDB::bind_method(D_METHOD("is_cancelled"), &TerrainMesher::is_cancelled);
+	ClassDB::bind_method(D_METHOD("set_cancelled", "value"), &TerrainMesher::set_cancelled);
+
+	ClassDB::bind_method(D_METHOD("copy_settings_from", "mesher"), &TerrainMesher::copy_settings_from);
 
 	ClassDB::bind_method(D_METHOD("generate_normals", "flip"), &TerrainMesher::generate_normals, DEFVAL(false));
 
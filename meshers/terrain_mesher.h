@@ -32,10 +32,12 @@ SOFTWARE.
 #endif
 #include "core/templates/vector.h"
 #include "core/math/color.h"
+#include "core/templates/safe_refcount.h"
 #else
 #include "core/reference.h"
 #include "core/vector.h"
 #include "core/color.h"
+#include "core/safe_refcount.h"
 #endif
 
 #include "../defines.h"
@@ -135,6 +137,11 @@ public:
 
 	bool get_is_liquid_mesher() const;
 	void set_is_liquid_mesher(const bool value);
+
+	bool is_cancelled() const;
+	void set_cancelled(const bool value);
+
+	void copy_settings_from(const Ref<TerrainMesher> &mesher);
 	
 	void reset();
 
@@ -153,6 +160,8 @@ public:
 	void bake_liquid_colors(Ref<TerrainChunk> chunk);
 
 	PoolVector<Vector3> build_collider() const;
+	Dictionary build_heightmap_collider(Ref<TerrainChunk> chunk) const;
+	Transform get_heightmap_collider_transform(Ref<TerrainChunk> chunk) const;
 
 	void bake_lights(MeshInstance *node, Vector<Ref<TerrainLight>> &lights);
 
@@ -211,6 +220,8 @@ public:
 protected:
 	static void _bind_methods();
 
+	int get_heightmap_collider_step(Ref<TerrainChunk> chunk) const;
+
 	int _channel_index_type;
 	int _channel_index_isolevel;
 
@@ -224,6 +235,8 @@ protected:
 
 	bool _is_liquid_mesher;
 
+	SafeFlag _cancelled;
+
 	PoolVector<Vertex> _vertices;
 	PoolVector<int> _indices;
 
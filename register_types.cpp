@@ -63,11 +63,14 @@ SOFTWARE.
 #include "nodes/terrain_light_node.h"
 
 #include "world/jobs/terrain_job.h"
+#include "world/jobs/terrain_generate_job.h"
 #include "world/jobs/terrain_light_job.h"
 #include "world/jobs/terrain_mesher_job_step.h"
 #include "world/jobs/terrain_prop_job.h"
 #include "world/jobs/terrain_terrain_job.h"
 
+#include "world/terrain_channel_allocator.h"
+
 void initialize_terraman_module(ModuleInitializationLevel p_level) {
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
 		GDREGISTER_CLASS(TerrainMesher);
@@ -112,6 +115,7 @@ void initialize_terraman_module(ModuleInitializationLevel p_level) {
 		GDREGISTER_CLASS(TerrainJob);
 		GDREGISTER_CLASS(TerrainTerrainJob);
 		GDREGISTER_CLASS(TerrainMesherJobStep);
+		GDREGISTER_CLASS(TerrainGenerateJob);
 		GDREGISTER_CLASS(TerrainLightJob);
 		GDREGISTER_CLASS(TerrainPropJob);
 	}
@@ -124,4 +128,7 @@ void initialize_terraman_module(ModuleInitializationLevel p_level) {
 }
 
 void uninitialize_terraman_module(ModuleInitializationLevel p_level) {
+	if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
+		TerrainChannelAllocator::clear();
+	}
 }
@@ -0,0 +1,205 @@
+// Compares the chunk position hashes TerrainWorld used, and the dense chunk grid.
+// The map mirrors Godot 3's HashMap: chained buckets, a power of two table that grows past 8 entries per bucket.
+// It doesn't need the engine:
+//   g++ -O2 tools/benchmark_chunk_lookup.cpp -o benchmark_chunk_lookup && ./benchmark_chunk_lookup
+// Set SHUFFLE=1 to look the chunks up in a random order, and STRIP=1 to use a 4 chunk wide strip instead of a square.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct IntPos {
+	int x;
+	int z;
+};
+
+static inline uint32_t hash_djb2_one_32(uint32_t p_in, uint32_t p_prev = 5381) {
+	return ((p_prev << 5) + p_prev) + p_in;
+}
+
+//the original one, it hashed x twice
+struct LegacyHasher {
+	static inline uint32_t hash(const IntPos &v) {
+		uint32_t hash = hash_djb2_one_32(v.x);
+		hash = hash_djb2_one_32(v.x, hash);
+		return hash_djb2_one_32(v.z, hash);
+	}
+};
+
+//murmur3 finalizer, well mixed, but it scatters neighbours all over the table
+struct MurmurHasher {
+	static inline uint32_t hash(const IntPos &v) {
+		uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(v.x)) << 32) | static_cast<uint32_t>(v.z);
+
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+
+		return static_cast<uint32_t>(h);
+	}
+};
+
+//TerrainWorld::IntPosHasher
+struct IntPosHasher {
+	static inline uint32_t hash(const IntPos &v) {
+		return static_cast<uint32_t>(v.x) * 0x9E3779B1u + static_cast<uint32_t>(v.z);
+	}
+};
+
+template <class H>
+class Map {
+public:
+	void set(const IntPos &key, const int value) {
+		uint32_t hash = H::hash(key);
+
+		_elements.push_back({ hash, key, value, -1 });
+		++_count;
+
+		if (_count > (1 << _power) * 8) {
+			++_power;
+			rehash();
+		} else {
+			link(static_cast<int>(_elements.size()) - 1);
+		}
+	}
+
+	const int *getptr(const IntPos &key) const {
+		uint32_t hash = H::hash(key);
+
+		for (int i = _buckets[hash & ((1 << _power) - 1)]; i != -1; i = _elements[i].next) {
+			const Element &e = _elements[i];
+
+			if (e.hash == hash && e.key.x == key.x && e.key.z == key.z) {
+				return &e.value;
+			}
+		}
+
+		return nullptr;
+	}
+
+	Map() {
+		_buckets.assign(1 << _power, -1);
+	}
+
+private:
+	struct Element {
+		uint32_t hash;
+		IntPos key;
+		int value;
+		int next;
+	};
+
+	void link(const int index) {
+		Element &e = _elements[index];
+		int bucket = e.hash & ((1 << _power) - 1);
+
+		e.next = _buckets[bucket];
+		_buckets[bucket] = index;
+	}
+
+	void rehash() {
+		_buckets.assign(1 << _power, -1);
+
+		for (int i = 0; i < static_cast<int>(_elements.size()); ++i) {
+			link(i);
+		}
+	}
+
+	std::vector<Element> _elements;
+	std::vector<int> _buckets;
+	int _power = 3;
+	int _count = 0;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_per_lookup(Clock::time_point start, const size_t lookups) {
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / lookups;
+}
+
+template <class H>
+static double benchmark_map(const std::vector<IntPos> &positions, const std::vector<IntPos> &order, const int passes, long &r_sum) {
+	Map<H> map;
+
+	for (size_t i = 0; i < positions.size(); ++i) {
+		map.set(positions[i], static_cast<int>(i));
+	}
+
+	Clock::time_point start = Clock::now();
+
+	for (int p = 0; p < passes; ++p) {
+		for (const IntPos &pos : order) {
+			const int *index = map.getptr(pos);
+
+			r_sum += index ? *index : -1;
+		}
+	}
+
+	return ns_per_lookup(start, order.size() * passes);
+}
+
+int main() {
+	const bool shuffle = getenv("SHUFFLE") != nullptr;
+	const bool strip = getenv("STRIP") != nullptr;
+	const int counts[] = { 289, 1089, 4225, 16641 };
+
+	printf("ns per lookup%s%s\n", shuffle ? ", shuffled" : "", strip ? ", strip" : "");
+
+	for (int count : counts) {
+		int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+		int width = strip ? 4 : side;
+		int length = count / width;
+
+		std::vector<IntPos> positions;
+
+		for (int z = 0; z < length; ++z) {
+			for (int x = 0; x < width; ++x) {
+				positions.push_back({ x - width / 2, z - length / 2 });
+			}
+		}
+
+		std::vector<IntPos> order = positions;
+
+		if (shuffle) {
+			std::shuffle(order.begin(), order.end(), std::mt19937(1));
+		}
+
+		int passes = 20000000 / count;
+		long sum = 0;
+
+		double legacy = benchmark_map<LegacyHasher>(positions, order, passes, sum);
+		double murmur = benchmark_map<MurmurHasher>(positions, order, passes, sum);
+		double current = benchmark_map<IntPosHasher>(positions, order, passes, sum);
+
+		std::vector<int> grid(width * length, -1);
+
+		for (size_t i = 0; i < positions.size(); ++i) {
+			grid[(positions[i].z + length / 2) * width + positions[i].x + width / 2] = static_cast<int>(i);
+		}
+
+		Clock::time_point start = Clock::now();
+
+		for (int p = 0; p < passes; ++p) {
+			for (const IntPos &pos : order) {
+				int gx = pos.x + width / 2;
+				int gz = pos.z + length / 2;
+
+				sum += (gx >= 0 && gz >= 0 && gx < width && gz < length) ? grid[gz * width + gx] : -1;
+			}
+		}
+
+		double dense = ns_per_lookup(start, order.size() * passes);
+
+		//the checksum keeps the lookups from being optimized away
+		printf("%6zu chunks: legacy %6.1f  murmur %6.1f  IntPosHasher %6.1f  grid %6.1f  (%ld)\n", positions.size(), legacy, murmur, current, dense, sum & 1);
+	}
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+extends SceneTree
+
+# Checks that chunks only keep memory for the channels that actually have a buffer.
+# Run it from a project that has the module compiled in:
+#   godot --no-window -s tools/check_channel_memory.gd
+
+const SIZE = 16
+const MARGIN_START = 1
+const MARGIN_END = 1
+
+var _failed : bool = false
+
+func _init():
+	var data_size : int = (SIZE + MARGIN_START + MARGIN_END) * (SIZE + MARGIN_START + MARGIN_END)
+	# buffers are 64 byte aligned
+	var block_size : int = (data_size + 63) / 64 * 64
+
+	var chunk : TerrainChunkDefault = TerrainChunkDefault.new()
+	chunk.set_size(SIZE, SIZE, MARGIN_START, MARGIN_END)
+
+	var generator : TerrainLevelGeneratorFlat = TerrainLevelGeneratorFlat.new()
+	generator.set_channel_map({
+		TerrainChunkDefault.DEFAULT_CHANNEL_TYPE: 1,
+		TerrainChunkDefault.DEFAULT_CHANNEL_ISOLEVEL: 80,
+		TerrainChunkDefault.DEFAULT_CHANNEL_LIGHT_COLOR_R: 0,
+		TerrainChunkDefault.DEFAULT_CHANNEL_AO: 0,
+	})
+
+	generator.generate_chunk(chunk)
+	chunk.channels_compact()
+
+	expect(chunk.get_channel_memory_usage() == 0, "a flat chunk doesn't have any buffers")
+
+	# a second id gives the type channel a buffer, nothing else
+	chunk.set_voxel(2, 3, 3, TerrainChunkDefault.DEFAULT_CHANNEL_TYPE)
+	expect(chunk.get_channel_memory_usage() == block_size, "only the type channel has a buffer")
+
+	chunk.set_voxel(81, 3, 3, TerrainChunkDefault.DEFAULT_CHANNEL_ISOLEVEL)
+	expect(chunk.get_channel_memory_usage() == 2 * block_size, "type and isolevel have buffers")
+
+	# with palette encoding the type channel keeps 2 ids and 1 bit indices
+	chunk.set_palette_channels(1 << TerrainChunkDefault.DEFAULT_CHANNEL_TYPE)
+	chunk.channels_compact()
+	expect(chunk.channel_is_palette_encoded(TerrainChunkDefault.DEFAULT_CHANNEL_TYPE), "the type channel is palette encoded")
+	expect(chunk.get_channel_memory_usage() == block_size + 2 + (data_size + 7) / 8, "the type channel only keeps its palette")
+
+	# the compressed form keeps the palette
+	var compressed : PoolByteArray = chunk.channel_get_compressed(TerrainChunkDefault.DEFAULT_CHANNEL_TYPE)
+	expect(compressed.size() < data_size / 8 + 32, "the compressed palette channel stays small")
+
+	var loaded : TerrainChunkDefault = TerrainChunkDefault.new()
+	loaded.set_size(SIZE, SIZE, MARGIN_START, MARGIN_END)
+	loaded.set_palette_channels(1 << TerrainChunkDefault.DEFAULT_CHANNEL_TYPE)
+	loaded.channel_set_compressed(TerrainChunkDefault.DEFAULT_CHANNEL_TYPE, compressed)
+	expect(loaded.channel_is_palette_encoded(TerrainChunkDefault.DEFAULT_CHANNEL_TYPE), "the loaded type channel is palette encoded")
+	expect(loaded.get_voxel(3, 3, TerrainChunkDefault.DEFAULT_CHANNEL_TYPE) == 2 && loaded.get_voxel(4, 3, TerrainChunkDefault.DEFAULT_CHANNEL_TYPE) == 1, "the loaded type channel has the same ids")
+
+	# overwritten ids get dropped from the palette
+	chunk.set_voxel(1, 3, 3, TerrainChunkDefault.DEFAULT_CHANNEL_TYPE)
+	expect(chunk.channel_get_palette(TerrainChunkDefault.DEFAULT_CHANNEL_TYPE).size() == 1, "the palette only has the ids in use")
+	chunk.channels_compact()
+	expect(chunk.get_channel_memory_usage() == block_size, "the type channel is uniform again")
+
+	quit(1 if _failed else 0)
+
+func expect(value : bool, message : String) -> void:
+	if value:
+		print("ok: " + message)
+	else:
+		_failed = true
+		push_error("failed: " + message)
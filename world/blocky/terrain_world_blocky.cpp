@@ -25,6 +25,7 @@ SOFTWARE.
 #include "terrain_chunk_blocky.h"
 
 #include "../../meshers/blocky/terrain_mesher_blocky.h"
+#include "../jobs/terrain_generate_job.h"
 #include "../jobs/terrain_light_job.h"
 #include "../jobs/terrain_prop_job.h"
 #include "../jobs/terrain_terrain_job.h"
@@ -35,6 +36,9 @@ Ref<TerrainChunk> TerrainWorldBlocky::_create_chunk(int x, int z, Ref<TerrainChu
 	}
 
 	if (chunk->job_get_count() == 0) {
+		Ref<TerrainGenerateJob> gj;
+		gj.instantiate();
+
 		Ref<TerrainTerrainJob> tj;
 		tj.instantiate();
 
@@ -98,6 +102,12 @@ Ref<TerrainChunk> TerrainWorldBlocky::_create_chunk(int x, int z, Ref<TerrainChu
 #endif
 		pj->add_jobs_step(s);
 
+		//terrain and prop meshing both only need the data and the baked lights
+		lj->dependency_add(gj);
+		tj->dependency_add(lj);
+		pj->dependency_add(lj);
+
+		chunk->job_add(gj);
 		chunk->job_add(lj);
 		chunk->job_add(tj);
 		chunk->job_add(pj);
@@ -39,7 +39,7 @@ SOFTWARE.
 #include "../jobs/terrain_prop_job.h"
 #include "../jobs/terrain_terrain_job.h"
 
-const String TerrainChunkDefault::BINDING_STRING_BUILD_FLAGS = "Use Isolevel,Use Lighting,Use AO,Use RAO,Generate AO,Generate RAO,Bake Lights,Create Collider,Create Lods";
+const String TerrainChunkDefault::BINDING_STRING_BUILD_FLAGS = "Use Isolevel,Use Lighting,Use AO,Use RAO,Generate AO,Generate RAO,Bake Lights,Create Collider,Create Lods,Heightmap Collider";
 
 _FORCE_INLINE_ int TerrainChunkDefault::get_build_flags() const {
 	return _build_flags;
@@ -107,13 +107,19 @@ void TerrainChunkDefault::emit_build_finished() {
 
 //Meshes
 Dictionary TerrainChunkDefault::mesh_rids_get() {
+	_THREAD_SAFE_METHOD_
+
 	return _rids;
 }
 void TerrainChunkDefault::mesh_rids_set(const Dictionary &rids) {
+	_THREAD_SAFE_METHOD_
+
 	_rids = rids;
 }
 
 RID TerrainChunkDefault::mesh_rid_get(const int mesh_index, const int mesh_type_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return RID();
 
@@ -135,6 +141,8 @@ RID TerrainChunkDefault::mesh_rid_get(const int mesh_index, const int mesh_type_
 	return v;
 }
 void TerrainChunkDefault::mesh_rid_set(const int mesh_index, const int mesh_type_index, RID value) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		_rids[mesh_index] = Dictionary();
 
@@ -158,6 +166,8 @@ void TerrainChunkDefault::mesh_rid_set(const int mesh_index, const int mesh_type
 	_rids[mesh_index] = m;
 }
 RID TerrainChunkDefault::mesh_rid_get_index(const int mesh_index, const int mesh_type_index, const int index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return RID();
 
@@ -178,6 +188,8 @@ RID TerrainChunkDefault::mesh_rid_get_index(const int mesh_index, const int mesh
 	return arr[index];
 }
 void TerrainChunkDefault::mesh_rid_set_index(const int mesh_index, const int mesh_type_index, const int index, RID value) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		_rids[mesh_index] = Dictionary();
 
@@ -208,6 +220,8 @@ void TerrainChunkDefault::mesh_rid_set_index(const int mesh_index, const int mes
 	_rids[mesh_index] = m;
 }
 int TerrainChunkDefault::mesh_rid_get_count(const int mesh_index, const int mesh_type_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return 0;
 
@@ -226,6 +240,8 @@ int TerrainChunkDefault::mesh_rid_get_count(const int mesh_index, const int mesh
 	return arr.size();
 }
 void TerrainChunkDefault::mesh_rids_clear(const int mesh_index, const int mesh_type_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return;
 
@@ -237,6 +253,8 @@ void TerrainChunkDefault::mesh_rids_clear(const int mesh_index, const int mesh_t
 	m.erase(mesh_type_index);
 }
 Array TerrainChunkDefault::meshes_get(const int mesh_index, const int mesh_type_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return Array();
 
@@ -253,6 +271,8 @@ Array TerrainChunkDefault::meshes_get(const int mesh_index, const int mesh_type_
 	return v;
 }
 void TerrainChunkDefault::meshes_set(const int mesh_index, const int mesh_type_index, const Array &meshes) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		_rids[mesh_index] = Dictionary();
 
@@ -262,6 +282,8 @@ void TerrainChunkDefault::meshes_set(const int mesh_index, const int mesh_type_i
 	_rids[mesh_index] = m;
 }
 bool TerrainChunkDefault::meshes_has(const int mesh_index, const int mesh_type_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return false;
 
@@ -274,10 +296,14 @@ bool TerrainChunkDefault::meshes_has(const int mesh_index, const int mesh_type_i
 }
 
 void TerrainChunkDefault::rids_clear() {
+	_THREAD_SAFE_METHOD_
+
 	_rids.clear();
 }
 
 void TerrainChunkDefault::rids_free() {
+	_THREAD_SAFE_METHOD_
+
 	List<Variant> keys;
 
 	_rids.get_key_list(&keys);
@@ -293,6 +319,8 @@ void TerrainChunkDefault::rids_free() {
 }
 
 void TerrainChunkDefault::meshes_create(const int mesh_index, const int mesh_count) {
+	_THREAD_SAFE_METHOD_
+
 	ERR_FAIL_COND(_voxel_world == NULL);
 	ERR_FAIL_COND(!get_library().is_valid());
 
@@ -332,6 +360,8 @@ void TerrainChunkDefault::meshes_create(const int mesh_index, const int mesh_cou
 	_rids[mesh_index] = m;
 }
 void TerrainChunkDefault::meshes_free(const int mesh_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return;
 
@@ -367,6 +397,14 @@ void TerrainChunkDefault::meshes_free(const int mesh_index) {
 }
 
 void TerrainChunkDefault::colliders_create(const int mesh_index, const int layer_mask) {
+	colliders_create_shape(mesh_index, PhysicsServer::SHAPE_CONCAVE_POLYGON, Transform(), layer_mask);
+}
+void TerrainChunkDefault::colliders_create_heightmap(const int mesh_index, const Transform &shape_transform, const int layer_mask) {
+	colliders_create_shape(mesh_index, PhysicsServer::SHAPE_HEIGHTMAP, shape_transform, layer_mask);
+}
+void TerrainChunkDefault::colliders_create_shape(const int mesh_index, const int shape_type, const Transform &shape_transform, const int layer_mask) {
+	_THREAD_SAFE_METHOD_
+
 	ERR_FAIL_COND(_voxel_world == NULL);
 	ERR_FAIL_COND(PhysicsServer::get_singleton()->is_flushing_queries());
 	//ERR_FAIL_COND(!get_voxel_world()->is_inside_tree());
@@ -377,15 +415,28 @@ void TerrainChunkDefault::colliders_create(const int mesh_index, const int layer
 	Dictionary m = _rids[mesh_index];
 
 	ERR_FAIL_COND(m.has(MESH_TYPE_INDEX_BODY));
+	ERR_FAIL_COND(m.has(MESH_TYPE_INDEX_SHARED_BODY));
 	ERR_FAIL_COND(m.has(MESH_TYPE_INDEX_SHAPE));
 
-	RID shape_rid = PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_CONCAVE_POLYGON);
+	RID shape_rid = PhysicsServer::get_singleton()->shape_create(static_cast<PhysicsServer::ShapeType>(shape_type));
+
+	if (_voxel_world->get_collider_region_size() > 0) {
+		//the region bodies use the world's transform
+		Transform t = _voxel_world->get_transform().affine_inverse() * get_transform() * shape_transform;
+
+		m[MESH_TYPE_INDEX_SHARED_BODY] = _voxel_world->collider_region_shape_add(get_position_x(), get_position_z(), shape_rid, t, layer_mask);
+		m[MESH_TYPE_INDEX_SHAPE] = shape_rid;
+
+		_rids[mesh_index] = m;
+		return;
+	}
+
 	RID body_rid = PhysicsServer::get_singleton()->body_create(PhysicsServer::BODY_MODE_STATIC);
 
 	PhysicsServer::get_singleton()->body_set_collision_layer(body_rid, layer_mask);
 	PhysicsServer::get_singleton()->body_set_collision_mask(body_rid, layer_mask);
 
-	PhysicsServer::get_singleton()->body_add_shape(body_rid, shape_rid);
+	PhysicsServer::get_singleton()->body_add_shape(body_rid, shape_rid, shape_transform);
 
 	PhysicsServer::get_singleton()->body_set_state(body_rid, PhysicsServer::BODY_STATE_TRANSFORM, get_transform());
 
@@ -402,6 +453,8 @@ void TerrainChunkDefault::colliders_create(const int mesh_index, const int layer
 	_rids[mesh_index] = m;
 }
 void TerrainChunkDefault::colliders_create_area(const int mesh_index, const int layer_mask) {
+	_THREAD_SAFE_METHOD_
+
 	ERR_FAIL_COND(_voxel_world == NULL);
 	ERR_FAIL_COND(PhysicsServer::get_singleton()->is_flushing_queries());
 
@@ -443,12 +496,19 @@ void TerrainChunkDefault::colliders_create_area(const int mesh_index, const int
 }
 
 void TerrainChunkDefault::colliders_free(const int mesh_index) {
+	_THREAD_SAFE_METHOD_
+
 	if (!_rids.has(mesh_index))
 		return;
 
 	Dictionary m = _rids[mesh_index];
 	RID rid;
 
+	//has to be taken out of the region body before it's freed
+	if (m.has(MESH_TYPE_INDEX_SHARED_BODY) && m.has(MESH_TYPE_INDEX_SHAPE) && _voxel_world) {
+		_voxel_world->collider_region_shape_remove(m[MESH_TYPE_INDEX_SHARED_BODY], m[MESH_TYPE_INDEX_SHAPE]);
+	}
+
 	if (m.has(MESH_TYPE_INDEX_SHAPE)) {
 		RID r = m[MESH_TYPE_INDEX_SHAPE];
 
@@ -463,16 +523,40 @@ void TerrainChunkDefault::colliders_free(const int mesh_index) {
 
 	m.erase(MESH_TYPE_INDEX_SHAPE);
 	m.erase(MESH_TYPE_INDEX_BODY);
+	m.erase(MESH_TYPE_INDEX_SHARED_BODY);
 
 	_rids[mesh_index] = m;
 }
 
+bool TerrainChunkDefault::colliders_has(const int mesh_index) {
+	return meshes_has(mesh_index, MESH_TYPE_INDEX_BODY) || meshes_has(mesh_index, MESH_TYPE_INDEX_SHARED_BODY);
+}
+void TerrainChunkDefault::colliders_set_shape_transform(const int mesh_index, const Transform &shape_transform) {
+	_THREAD_SAFE_METHOD_
+
+	RID shape = mesh_rid_get(mesh_index, MESH_TYPE_INDEX_SHAPE);
+	RID body = mesh_rid_get(mesh_index, MESH_TYPE_INDEX_BODY);
+
+	if (body != RID()) {
+		PhysicsServer::get_singleton()->body_set_shape_transform(body, 0, shape_transform);
+		return;
+	}
+
+	body = mesh_rid_get(mesh_index, MESH_TYPE_INDEX_SHARED_BODY);
+
+	if (body != RID() && _voxel_world) {
+		_voxel_world->collider_region_shape_set_transform(body, shape, _voxel_world->get_transform().affine_inverse() * get_transform() * shape_transform);
+	}
+}
+
 void TerrainChunkDefault::free_index(const int mesh_index) {
 	meshes_free(mesh_index);
 	colliders_free(mesh_index);
 }
 
 void TerrainChunkDefault::update_transforms() {
+	_THREAD_SAFE_METHOD_
+
 	RID empty_rid;
 	Transform t = get_transform();
 
@@ -729,15 +813,83 @@ void TerrainChunkDefault::_visibility_changed(bool visible) {
 	}
 }
 
+void TerrainChunkDefault::_streaming_flags_changed(const int old_flags) {
+	//the current build will free them in _finalize_build
+	if (_is_generating) {
+		return;
+	}
+
+	rids_free_unstreamed();
+}
+
+void TerrainChunkDefault::_enter_tree() {
+	TerrainChunk::_enter_tree();
+
+	if (!_voxel_world || !_voxel_world->is_inside_world()) {
+		return;
+	}
+
+	Ref<World> world = _voxel_world->GET_WORLD();
+
+	if (!world.is_valid() || world->get_space() == RID()) {
+		return;
+	}
+
+	//recycled chunks keep their bodies, but they are taken out of the space
+	for (int i = 0; i < MESH_INDEX_CLUTTER; ++i) {
+		RID body = mesh_rid_get(i, MESH_TYPE_INDEX_BODY);
+
+		if (body != RID()) {
+			PhysicsServer::get_singleton()->body_set_space(body, world->get_space());
+		}
+	}
+}
+
 void TerrainChunkDefault::_exit_tree() {
 	TerrainChunk::_exit_tree();
 
-	if (!_is_generating) {
+	if (!_is_generating && !_is_pooled) {
 		rids_free();
 		rids_clear();
 	}
 }
 
+void TerrainChunkDefault::_recycle() {
+	_THREAD_SAFE_METHOD_
+
+	TerrainChunk::_recycle();
+
+	_lights.clear();
+	_lights_dirty = false;
+	_current_lod_level = 0;
+
+	//rids are kept for the next use, they just must not be visible / collide until then
+	for (int i = 0; i < MESH_INDEX_CLUTTER; ++i) {
+		int count = mesh_rid_get_count(i, MESH_TYPE_INDEX_MESH_INSTANCE);
+
+		for (int j = 0; j < count; ++j) {
+			RID rid = mesh_rid_get_index(i, MESH_TYPE_INDEX_MESH_INSTANCE, j);
+
+			if (rid != RID()) {
+				VS::get_singleton()->instance_set_visible(rid, false);
+			}
+		}
+
+		RID body = mesh_rid_get(i, MESH_TYPE_INDEX_BODY);
+
+		if (body != RID()) {
+			PhysicsServer::get_singleton()->body_set_space(body, RID());
+		}
+
+		//region bodies are shared, so these can't just be taken out of the space
+		if (meshes_has(i, MESH_TYPE_INDEX_SHARED_BODY)) {
+			colliders_free(i);
+		}
+	}
+
+	debug_mesh_clear();
+}
+
 void TerrainChunkDefault::_world_transform_changed() {
 	TerrainChunk::_world_transform_changed();
 
@@ -846,6 +998,26 @@ void TerrainChunkDefault::free_chunk() {
 	rids_free();
 }
 
+void TerrainChunkDefault::rids_free_unstreamed() {
+	if ((_streaming_flags & STREAMING_FLAG_RENDER) == 0) {
+		meshes_free(MESH_INDEX_TERRAIN);
+		meshes_free(MESH_INDEX_LIQUID);
+		meshes_free(MESH_INDEX_PROP);
+	}
+
+	if ((_streaming_flags & STREAMING_FLAG_COLLIDER) == 0) {
+		colliders_free(MESH_INDEX_TERRAIN);
+		colliders_free(MESH_INDEX_LIQUID);
+		colliders_free(MESH_INDEX_PROP);
+
+		for (int i = 0; i < collider_get_count(); ++i) {
+			PhysicsServer::get_singleton()->free(collider_get_body(i));
+		}
+
+		colliders_clear();
+	}
+}
+
 void TerrainChunkDefault::_finalize_build() {
 	ERR_FAIL_COND(!_library.is_valid());
 
@@ -858,6 +1030,10 @@ void TerrainChunkDefault::_finalize_build() {
 	set_current_lod_level(get_current_lod_level());
 
 	call_deferred("update_transforms");
+
+	if (_streaming_flags != STREAMING_FLAGS_ALL) {
+		call_deferred("rids_free_unstreamed");
+	}
 }
 
 TerrainChunkDefault::TerrainChunkDefault() {
@@ -884,6 +1060,19 @@ TerrainChunkDefault::~TerrainChunkDefault() {
 
 void TerrainChunkDefault::_channel_setup() {
 	channel_set_count(MAX_DEFAULT_CHANNELS);
+
+	//picked using channel_benchmark_compression(), lz4 and rle stay fast enough to use while streaming
+	//only isolevels are smooth enough for the 2d prediction to help, lights and ao have long runs of the same value that the filter breaks up,
+	//liquids are mostly empty, and random ao is noise, so it's stored as it is
+	channel_set_compression(DEFAULT_CHANNEL_TYPE, CHANNEL_FILTER_NONE, CHANNEL_CODEC_LZ4);
+	channel_set_compression(DEFAULT_CHANNEL_ISOLEVEL, CHANNEL_FILTER_PREDICT_2D, CHANNEL_CODEC_LZ4);
+	channel_set_compression(DEFAULT_CHANNEL_LIQUID_TYPE, CHANNEL_FILTER_NONE, CHANNEL_CODEC_RLE);
+	channel_set_compression(DEFAULT_CHANNEL_LIQUID_ISOLEVEL, CHANNEL_FILTER_NONE, CHANNEL_CODEC_RLE);
+	channel_set_compression(DEFAULT_CHANNEL_LIGHT_COLOR_R, CHANNEL_FILTER_NONE, CHANNEL_CODEC_LZ4);
+	channel_set_compression(DEFAULT_CHANNEL_LIGHT_COLOR_G, CHANNEL_FILTER_NONE, CHANNEL_CODEC_LZ4);
+	channel_set_compression(DEFAULT_CHANNEL_LIGHT_COLOR_B, CHANNEL_FILTER_NONE, CHANNEL_CODEC_LZ4);
+	channel_set_compression(DEFAULT_CHANNEL_AO, CHANNEL_FILTER_NONE, CHANNEL_CODEC_LZ4);
+	channel_set_compression(DEFAULT_CHANNEL_RANDOM_AO, CHANNEL_FILTER_NONE, CHANNEL_CODEC_RAW);
 }
 
 void TerrainChunkDefault::_bind_methods() {
@@ -925,7 +1114,10 @@ void TerrainChunkDefault::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("meshes_free", "mesh_index"), &TerrainChunkDefault::meshes_free);
 
 	ClassDB::bind_method(D_METHOD("create_colliders", "mesh_index", "layer_mask"), &TerrainChunkDefault::colliders_create, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("create_heightmap_colliders", "mesh_index", "shape_transform", "layer_mask"), &TerrainChunkDefault::colliders_create_heightmap, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("free_colliders", "mesh_index"), &TerrainChunkDefault::colliders_free);
+	ClassDB::bind_method(D_METHOD("colliders_has", "mesh_index"), &TerrainChunkDefault::colliders_has);
+	ClassDB::bind_method(D_METHOD("colliders_set_shape_transform", "mesh_index", "shape_transform"), &TerrainChunkDefault::colliders_set_shape_transform);
 
 	//Lights
 	ClassDB::bind_method(D_METHOD("get_light", "index"), &TerrainChunkDefault::get_light);
@@ -950,6 +1142,7 @@ void TerrainChunkDefault::_bind_methods() {
 
 	//Free
 	ClassDB::bind_method(D_METHOD("free_chunk"), &TerrainChunkDefault::free_chunk);
+	ClassDB::bind_method(D_METHOD("rids_free_unstreamed"), &TerrainChunkDefault::rids_free_unstreamed);
 
 	//etc
 	ClassDB::bind_method(D_METHOD("emit_build_finished"), &TerrainChunkDefault::emit_build_finished);
@@ -958,6 +1151,7 @@ void TerrainChunkDefault::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_channel_setup"), &TerrainChunkDefault::_channel_setup);
 
 	ClassDB::bind_method(D_METHOD("_visibility_changed", "visible"), &TerrainChunkDefault::_visibility_changed);
+	ClassDB::bind_method(D_METHOD("_streaming_flags_changed", "old_flags"), &TerrainChunkDefault::_streaming_flags_changed);
 
 	//lights
 	ClassDB::bind_method(D_METHOD("_bake_lights"), &TerrainChunkDefault::_bake_lights);
@@ -989,6 +1183,7 @@ void TerrainChunkDefault::_bind_methods() {
 	BIND_CONSTANT(MESH_TYPE_INDEX_MESH_INSTANCE);
 	BIND_CONSTANT(MESH_TYPE_INDEX_SHAPE);
 	BIND_CONSTANT(MESH_TYPE_INDEX_BODY);
+	BIND_CONSTANT(MESH_TYPE_INDEX_SHARED_BODY);
 
 	BIND_ENUM_CONSTANT(BUILD_FLAG_USE_ISOLEVEL);
 	BIND_ENUM_CONSTANT(BUILD_FLAG_USE_LIGHTING);
@@ -999,4 +1194,5 @@ void TerrainChunkDefault::_bind_methods() {
 	BIND_ENUM_CONSTANT(BUILD_FLAG_BAKE_LIGHTS);
 	BIND_ENUM_CONSTANT(BUILD_FLAG_CREATE_COLLIDER);
 	BIND_ENUM_CONSTANT(BUILD_FLAG_CREATE_LODS);
+	BIND_ENUM_CONSTANT(BUILD_FLAG_HEIGHTMAP_COLLIDER);
 }
@@ -88,6 +88,7 @@ public:
 		MESH_TYPE_INDEX_SHAPE,
 		MESH_TYPE_INDEX_BODY,
 		MESH_TYPE_INDEX_AREA,
+		MESH_TYPE_INDEX_SHARED_BODY,
 	};
 
 	//TODO these should be removed, as it would be easier to customize these during World's _create_chunk.
@@ -101,6 +102,7 @@ public:
 		BUILD_FLAG_BAKE_LIGHTS = 1 << 6,
 		BUILD_FLAG_CREATE_COLLIDER = 1 << 7,
 		BUILD_FLAG_CREATE_LODS = 1 << 8,
+		BUILD_FLAG_HEIGHTMAP_COLLIDER = 1 << 9,
 	};
 
 public:
@@ -141,8 +143,12 @@ public:
 	void meshes_free(const int mesh_index);
 
 	void colliders_create(const int mesh_index, const int layer_mask = 1);
+	void colliders_create_heightmap(const int mesh_index, const Transform &shape_transform, const int layer_mask = 1);
+	void colliders_create_shape(const int mesh_index, const int shape_type, const Transform &shape_transform, const int layer_mask = 1);
 	void colliders_create_area(const int mesh_index, const int layer_mask = 1);
 	void colliders_free(const int mesh_index);
+	bool colliders_has(const int mesh_index);
+	void colliders_set_shape_transform(const int mesh_index, const Transform &shape_transform);
 
 	void free_index(const int mesh_index);
 
@@ -173,6 +179,7 @@ public:
 
 	//free
 	void free_chunk();
+	void rids_free_unstreamed();
 
 	//etc
 	void emit_build_finished();
@@ -191,8 +198,11 @@ protected:
 	virtual void _channel_setup();
 
 	virtual void _visibility_changed(bool visible);
+	virtual void _streaming_flags_changed(const int old_flags);
 
+	virtual void _enter_tree();
 	virtual void _exit_tree();
+	virtual void _recycle();
 	virtual void _world_transform_changed();
 
 	//lights
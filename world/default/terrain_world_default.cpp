@@ -27,6 +27,7 @@ SOFTWARE.
 #include "../../defines.h"
 
 #include "../../meshers/default/terrain_mesher_default.h"
+#include "../jobs/terrain_generate_job.h"
 #include "../jobs/terrain_light_job.h"
 #include "../jobs/terrain_prop_job.h"
 #include "../jobs/terrain_terrain_job.h"
@@ -181,6 +182,9 @@ Ref<TerrainChunk> TerrainWorldDefault::_create_chunk(int x, int z, Ref<TerrainCh
 	}
 
 	if (chunk->job_get_count() == 0) {
+		Ref<TerrainGenerateJob> gj;
+		gj.instantiate();
+
 		Ref<TerrainTerrainJob> tj;
 		tj.instantiate();
 
@@ -214,6 +218,12 @@ Ref<TerrainChunk> TerrainWorldDefault::_create_chunk(int x, int z, Ref<TerrainCh
 		s->set_job_type(TerrainMesherJobStep::TYPE_BAKE_TEXTURE);
 		tj->add_jobs_step(s);
 
+		//terrain and prop meshing both only need the data and the baked lights
+		lj->dependency_add(gj);
+		tj->dependency_add(lj);
+		pj->dependency_add(lj);
+
+		chunk->job_add(gj);
 		chunk->job_add(lj);
 		chunk->job_add(tj);
 		chunk->job_add(pj);
@@ -229,6 +239,20 @@ Ref<TerrainChunk> TerrainWorldDefault::_create_chunk(int x, int z, Ref<TerrainCh
 	return TerrainWorld::_create_chunk(x, z, chunk);
 }
 
+void TerrainWorldDefault::_pregenerate_chunk_lighting(Ref<TerrainChunk> chunk) {
+	Ref<TerrainChunkDefault> c = chunk;
+
+	if (!c.is_valid()) {
+		return;
+	}
+
+	//same ao and light baking as a build, just on a job that is not attached to the chunk
+	Ref<TerrainLightJob> job;
+	job.INSTANCE();
+	job->set_chunk(c);
+	job->phase_light();
+}
+
 void TerrainWorldDefault::_chunk_added(Ref<TerrainChunk> chunk) {
 	Ref<TerrainChunkDefault> c = chunk;
 
@@ -57,6 +57,7 @@ protected:
 	Ref<TerrainChunk> _create_chunk(int x, int z, Ref<TerrainChunk> p_chunk);
 	virtual void _chunk_added(Ref<TerrainChunk> chunk);
 	int _get_channel_index_info(const ChannelTypeInfo channel_type);
+	void _pregenerate_chunk_lighting(Ref<TerrainChunk> chunk);
 
 	//virtual void _notification(int p_what);
 
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "terrain_generate_job.h"
+
+#include "../../defines.h"
+
+#include "../terrain_chunk.h"
+#include "../terrain_world.h"
+
+void TerrainGenerateJob::phase_generate() {
+	TerrainWorld *world = _chunk->get_voxel_world();
+
+	ERR_FAIL_COND(!world);
+
+	world->chunk_generate_data(_chunk);
+
+	_chunk->set_is_generation_pending(false);
+}
+
+void TerrainGenerateJob::_process(float delta) {
+	//main thread fallback
+	if (_phase == 0) {
+		phase_generate();
+
+		set_build_phase_type(BUILD_PHASE_TYPE_NORMAL);
+		next_phase();
+	}
+}
+
+void TerrainGenerateJob::_execute_phase() {
+	ERR_FAIL_COND(!_chunk.is_valid());
+
+	if (_phase == 0) {
+		phase_generate();
+		next_phase();
+	}
+
+	set_complete(true); //So threadpool knows it's done
+	next_job();
+}
+
+void TerrainGenerateJob::_reset() {
+	TerrainJob::_reset();
+
+	_build_done = false;
+	_phase = 0;
+
+	if (!_chunk.is_valid() || !_chunk->get_is_generation_pending()) {
+		//nothing to generate (e.g. a rebuild after an edit), just pass through
+		_phase = 1;
+		set_build_phase_type(BUILD_PHASE_TYPE_NORMAL);
+		return;
+	}
+
+	TerrainWorld *world = _chunk->get_voxel_world();
+
+	if (world && world->is_generation_thread_safe()) {
+		set_build_phase_type(BUILD_PHASE_TYPE_NORMAL);
+	} else {
+		set_build_phase_type(BUILD_PHASE_TYPE_PROCESS);
+	}
+}
+
+TerrainGenerateJob::TerrainGenerateJob() {
+}
+
+TerrainGenerateJob::~TerrainGenerateJob() {
+}
+
+void TerrainGenerateJob::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("_process", "delta"), &TerrainGenerateJob::_process);
+}
@@ -0,0 +1,48 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef TERRAIN_GENERATE_JOB_H
+#define TERRAIN_GENERATE_JOB_H
+
+#include "terrain_job.h"
+
+//Runs TerrainWorld::chunk_generate_data() (level generator + structures) as the first job of a chunk.
+//If TerrainWorld::is_generation_thread_safe() returns false (script generators), the job falls back
+//to running generation on the main thread from the process notification.
+class TerrainGenerateJob : public TerrainJob {
+	GDCLASS(TerrainGenerateJob, TerrainJob);
+
+public:
+	void phase_generate();
+
+	void _process(float delta);
+	void _execute_phase();
+	void _reset();
+
+	TerrainGenerateJob();
+	~TerrainGenerateJob();
+
+protected:
+	static void _bind_methods();
+};
+
+#endif
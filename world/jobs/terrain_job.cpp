@@ -22,6 +22,7 @@ SOFTWARE.
 
 #include "terrain_job.h"
 
+#include "../../library/terrain_material_cache.h"
 #include "../default/terrain_chunk_default.h"
 
 #include "../../../opensimplex/open_simplex_noise.h"
@@ -51,6 +52,11 @@ void TerrainJob::next_phase() {
 	++_phase;
 }
 
+//identifies the current job type + phase pair, used by the world to keep per step cost estimates
+int TerrainJob::get_build_step_id() {
+	return static_cast<int>(hash_djb2_one_32(static_cast<uint32_t>(_phase), get_class_name().hash()));
+}
+
 bool TerrainJob::get_build_done() {
 	return _build_done;
 }
@@ -59,16 +65,118 @@ void TerrainJob::set_build_done(const bool val) {
 }
 
 void TerrainJob::next_job() {
-	_chunk->job_next();
+	release_resources();
+
+	_chunk->job_complete(Ref<TerrainJob>(this));
 	set_build_done(true);
 }
 
+//jobs without dependencies run after the previous job in their chunk's list
+Ref<TerrainJob> TerrainJob::dependency_get(const int index) const {
+	ERR_FAIL_INDEX_V(index, _dependencies.size(), Ref<TerrainJob>());
+
+	return _dependencies[index];
+}
+void TerrainJob::dependency_add(const Ref<TerrainJob> &job) {
+	ERR_FAIL_COND(!job.is_valid());
+	ERR_FAIL_COND(job.ptr() == this);
+
+	_dependencies.push_back(job);
+}
+int TerrainJob::dependency_get_count() const {
+	return _dependencies.size();
+}
+void TerrainJob::dependencies_clear() {
+	_dependencies.clear();
+}
+bool TerrainJob::depends_on(const Ref<TerrainJob> &job) const {
+	for (int i = 0; i < _dependencies.size(); ++i) {
+		if (_dependencies[i] == job) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TerrainJob::is_parked() {
+	MutexLock lock(_park_mutex);
+
+	return _parked;
+}
+//Returns true if the cache can be used. Otherwise the job gets parked, the current phase should return without
+//advancing, and the job gets re-queued (running the same phase again) when the cache finishes initializing.
+bool TerrainJob::wait_for_material_cache(const Ref<TerrainMaterialCache> &cache) {
+	ERR_FAIL_COND_V(!cache.is_valid(), true);
+
+	_park_mutex.lock();
+	_parked = true;
+	_parked_idle = false;
+	_resume_requested = false;
+	_park_mutex.unlock();
+
+	if (cache->initialization_wait(this, "resume")) {
+		_park_mutex.lock();
+		_parked = false;
+		_park_mutex.unlock();
+
+		return true;
+	}
+
+	return false;
+}
+void TerrainJob::resume() {
+	_park_mutex.lock();
+
+	if (!_parked) {
+		_park_mutex.unlock();
+		return;
+	}
+
+	if (!_parked_idle) {
+		//still returning from _execute on its thread, it will pick this up itself
+		_resume_requested = true;
+		_park_mutex.unlock();
+		return;
+	}
+
+	_parked = false;
+	_parked_idle = false;
+	_park_mutex.unlock();
+
+	if (!_chunk.is_valid()) {
+		return;
+	}
+
+	if (get_cancelled() || !_in_tree) {
+		release_resources();
+
+		if (get_cancelled()) {
+			_chunk->job_complete(Ref<TerrainJob>(this));
+		}
+
+		if (!_in_tree) {
+			_chunk.unref();
+		}
+
+		return;
+	}
+
+	_chunk->job_submit(Ref<TerrainJob>(this));
+}
+
 void TerrainJob::reset() {
 	call("_reset");
 }
 void TerrainJob::_reset() {
 	_build_done = false;
 	_phase = 0;
+
+	_park_mutex.lock();
+	_parked = false;
+	_parked_idle = false;
+	_resume_requested = false;
+	_park_mutex.unlock();
 }
 
 void TerrainJob::_execute() {
@@ -77,12 +185,79 @@ void TerrainJob::_execute() {
 
 	while (!get_cancelled() && _in_tree && !_build_done && origpt == _build_phase_type && !should_return()) {
 		execute_phase();
+
+		_park_mutex.lock();
+
+		if (_parked) {
+			//cancel() can't complete a job that is still on its thread, it gets completed below instead
+			if (!_resume_requested && !get_cancelled()) {
+				//resume() will queue the job again
+				_parked_idle = true;
+				_park_mutex.unlock();
+				return;
+			}
+
+			_parked = false;
+			_resume_requested = false;
+		}
+
+		_park_mutex.unlock();
+	}
+
+	if (get_cancelled() && _chunk.is_valid()) {
+		release_resources();
+
+		//hand the job back right away, so the chunk can be freed without waiting for anything else
+		_chunk->job_complete(Ref<TerrainJob>(this));
+	}
+
+	if (!_in_tree) {
+		_chunk.unref();
+	}
+}
+
+//marks the job cancelled, and lets it stop the work that doesn't check get_cancelled() (like meshers)
+void TerrainJob::cancel() {
+	set_cancelled(true);
+
+	_park_mutex.lock();
+
+	call("_cancel");
+
+	//a parked job isn't queued anywhere, so nothing else would hand it back to its chunk
+	bool parked = _parked && _parked_idle;
+
+	if (parked) {
+		_parked = false;
+		_parked_idle = false;
+	}
+
+	_park_mutex.unlock();
+
+	if (!parked || !_chunk.is_valid()) {
+		return;
 	}
 
+	release_resources();
+
+	_chunk->job_complete(Ref<TerrainJob>(this));
+
 	if (!_in_tree) {
 		_chunk.unref();
 	}
 }
+void TerrainJob::_cancel() {
+}
+
+//called when the job stops running, either because it's done or because it got cancelled
+//things that are only needed while running (like borrowed meshers) should be given back here
+void TerrainJob::release_resources() {
+	MutexLock lock(_park_mutex);
+
+	call("_release_resources");
+}
+void TerrainJob::_release_resources() {
+}
 
 void TerrainJob::execute_phase() {
 	call("_execute_phase");
@@ -294,6 +469,23 @@ void TerrainJob::chunk_exit_tree() {
 	}
 }
 
+//the chunk is going to be reused, set_chunk() gets called again when it enters the world
+void TerrainJob::chunk_recycled() {
+	_build_done = true;
+	_phase = 0;
+
+	_park_mutex.lock();
+	_parked = false;
+	_parked_idle = false;
+	_resume_requested = false;
+	_park_mutex.unlock();
+
+	release_resources();
+
+	set_cancelled(false);
+	set_complete(true);
+}
+
 TerrainJob::TerrainJob() {
 	_in_tree = false;
 
@@ -301,6 +493,10 @@ TerrainJob::TerrainJob() {
 	_build_done = true;
 	_phase = 0;
 
+	_parked = false;
+	_parked_idle = false;
+	_resume_requested = false;
+
 #if !THREAD_POOL_PRESENT
 	_complete = true;
 	_cancelled = false;
@@ -315,6 +511,7 @@ TerrainJob::TerrainJob() {
 
 TerrainJob::~TerrainJob() {
 	_chunk.unref();
+	_dependencies.clear();
 }
 
 void TerrainJob::_bind_methods() {
@@ -330,12 +527,23 @@ void TerrainJob::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_phase"), &TerrainJob::get_phase);
 	ClassDB::bind_method(D_METHOD("set_phase", "phase"), &TerrainJob::set_phase);
 	ClassDB::bind_method(D_METHOD("next_phase"), &TerrainJob::next_phase);
+	ClassDB::bind_method(D_METHOD("get_build_step_id"), &TerrainJob::get_build_step_id);
 
 	ClassDB::bind_method(D_METHOD("get_build_done"), &TerrainJob::get_build_done);
 	ClassDB::bind_method(D_METHOD("set_build_done", "val"), &TerrainJob::set_build_done);
 
 	ClassDB::bind_method(D_METHOD("next_job"), &TerrainJob::next_job);
 
+	ClassDB::bind_method(D_METHOD("dependency_get", "index"), &TerrainJob::dependency_get);
+	ClassDB::bind_method(D_METHOD("dependency_add", "job"), &TerrainJob::dependency_add);
+	ClassDB::bind_method(D_METHOD("dependency_get_count"), &TerrainJob::dependency_get_count);
+	ClassDB::bind_method(D_METHOD("dependencies_clear"), &TerrainJob::dependencies_clear);
+	ClassDB::bind_method(D_METHOD("depends_on", "job"), &TerrainJob::depends_on);
+
+	ClassDB::bind_method(D_METHOD("is_parked"), &TerrainJob::is_parked);
+	ClassDB::bind_method(D_METHOD("wait_for_material_cache", "cache"), &TerrainJob::wait_for_material_cache);
+	ClassDB::bind_method(D_METHOD("resume"), &TerrainJob::resume);
+
 	//BIND_VMETHOD(MethodInfo("_reset"));
 
 	ClassDB::bind_method(D_METHOD("reset"), &TerrainJob::reset);
@@ -343,6 +551,12 @@ void TerrainJob::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_execute"), &TerrainJob::_execute);
 
+	ClassDB::bind_method(D_METHOD("cancel"), &TerrainJob::cancel);
+	ClassDB::bind_method(D_METHOD("_cancel"), &TerrainJob::_cancel);
+
+	ClassDB::bind_method(D_METHOD("release_resources"), &TerrainJob::release_resources);
+	ClassDB::bind_method(D_METHOD("_release_resources"), &TerrainJob::_release_resources);
+
 	//BIND_VMETHOD(MethodInfo("_execute_phase"));
 
 	ClassDB::bind_method(D_METHOD("execute_phase"), &TerrainJob::execute_phase);
@@ -352,6 +566,7 @@ void TerrainJob::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("generate_random_ao", "seed", "octaves", "period", "persistence", "scale_factor"), &TerrainJob::generate_random_ao, DEFVAL(4), DEFVAL(30), DEFVAL(0.3), DEFVAL(0.6));
 
 	ClassDB::bind_method(D_METHOD("chunk_exit_tree"), &TerrainJob::chunk_exit_tree);
+	ClassDB::bind_method(D_METHOD("chunk_recycled"), &TerrainJob::chunk_recycled);
 
 #if !THREAD_POOL_PRESENT
 	ClassDB::bind_method(D_METHOD("get_complete"), &TerrainJob::get_complete);
@@ -23,6 +23,7 @@ SOFTWARE.
 #ifndef TERRAIN_JOB_H
 #define TERRAIN_JOB_H
 
+#include "core/os/mutex.h"
 #include "scene/resources/texture.h"
 
 #if THREAD_POOL_PRESENT
@@ -46,6 +47,7 @@ SOFTWARE.
 #endif
 
 class TerrainChunk;
+class TerrainMaterialCache;
 
 #if THREAD_POOL_PRESENT
 class TerrainJob : public ThreadPoolJob {
@@ -74,16 +76,34 @@ public:
 	void set_phase(const int phase);
 	void next_phase();
 
+	int get_build_step_id();
+
 	bool get_build_done();
 	void set_build_done(const bool val);
 
 	void next_job();
 
+	Ref<TerrainJob> dependency_get(const int index) const;
+	void dependency_add(const Ref<TerrainJob> &job);
+	int dependency_get_count() const;
+	void dependencies_clear();
+	bool depends_on(const Ref<TerrainJob> &job) const;
+
+	bool is_parked();
+	bool wait_for_material_cache(const Ref<TerrainMaterialCache> &cache);
+	void resume();
+
 	void reset();
 	virtual void _reset();
 
 	void _execute();
 
+	void cancel();
+	virtual void _cancel();
+
+	void release_resources();
+	virtual void _release_resources();
+
 	void execute_phase();
 	virtual void _execute_phase();
 
@@ -96,6 +116,7 @@ public:
 	Array bake_mesh_array_uv(Array arr, Ref<Texture> tex, float mul_color = 0.7) const;
 
 	void chunk_exit_tree();
+	void chunk_recycled();
 
 	TerrainJob();
 	~TerrainJob();
@@ -108,6 +129,13 @@ protected:
 	int _phase;
 	bool _in_tree;
 	Ref<TerrainChunk> _chunk;
+	Vector<Ref<TerrainJob>> _dependencies;
+
+	//also guards swapping borrowed meshers in and out, as cancel() reaches them from the main thread
+	Mutex _park_mutex;
+	bool _parked;
+	bool _parked_idle;
+	bool _resume_requested;
 
 public:
 #if !THREAD_POOL_PRESENT
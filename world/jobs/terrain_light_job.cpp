@@ -34,7 +34,7 @@ void TerrainLightJob::phase_light() {
 	Ref<TerrainChunkDefault> chunk = _chunk;
 
 	if ((chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_GENERATE_AO) != 0)
-		if (!chunk->channel_get(TerrainChunkDefault::DEFAULT_CHANNEL_AO))
+		if (!chunk->channel_is_allocated(TerrainChunkDefault::DEFAULT_CHANNEL_AO))
 			generate_ao();
 
 	bool gr = (chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_AUTO_GENERATE_RAO) != 0;
@@ -78,7 +78,9 @@ void TerrainLightJob::_execute_phase() {
 
 	ERR_FAIL_COND(!library.is_valid());
 
+	//the light and ao channels are data, gameplay can use them without meshes (the mesh colors are baked by the terrain job)
 	phase_light();
+
 	set_complete(true);
 	next_job();
 }
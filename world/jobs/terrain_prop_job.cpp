@@ -31,6 +31,7 @@ SOFTWARE.
 #include "../../meshers/default/terrain_mesher_default.h"
 #include "../../meshers/terrain_mesher.h"
 #include "../default/terrain_chunk_default.h"
+#include "../terrain_world.h"
 
 #ifdef MESH_DATA_RESOURCE_PRESENT
 #include "../../../mesh_data_resource/mesh_data_resource.h"
@@ -46,6 +47,12 @@ Ref<TerrainMesher> TerrainPropJob::get_prop_mesher() const {
 	return _prop_mesher;
 }
 void TerrainPropJob::set_prop_mesher(const Ref<TerrainMesher> &mesher) {
+	if (_prop_mesher_settings.is_valid()) {
+		//used from the next build
+		_prop_mesher_settings = mesher;
+		return;
+	}
+
 	_prop_mesher = mesher;
 }
 
@@ -81,6 +88,12 @@ void TerrainPropJob::phase_physics_process() {
 
 	chunk->colliders_clear();
 
+	if ((chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_COLLIDER) == 0) {
+		set_build_phase_type(BUILD_PHASE_TYPE_NORMAL);
+		next_phase();
+		return;
+	}
+
 #ifdef MESH_DATA_RESOURCE_PRESENT
 	for (int i = 0; i < chunk->mesh_data_resource_get_count(); ++i) {
 		Ref<MeshDataResource> mdr = chunk->mesh_data_resource_get(i);
@@ -148,6 +161,10 @@ void TerrainPropJob::phase_prop() {
 		}
 
 		for (int i = 0; i < chunk->mesh_data_resource_get_count(); ++i) {
+			if (get_cancelled()) {
+				return;
+			}
+
 			if (chunk->mesh_data_resource_get_is_inside(i)) {
 				get_prop_mesher()->add_mesh_data_resource_transform(chunk->mesh_data_resource_get(i), chunk->mesh_data_resource_get_transform(i), chunk->mesh_data_resource_get_uv_rect(i));
 			}
@@ -230,7 +247,7 @@ void TerrainPropJob::_execute_phase() {
 
 	Ref<TerrainChunkDefault> chunk = _chunk;
 
-	if (!chunk.is_valid()
+	if (!chunk.is_valid() || (chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) == 0
 #ifdef MESH_DATA_RESOURCE_PRESENT
 			|| chunk->mesh_data_resource_get_count() == 0
 #endif
@@ -262,18 +279,55 @@ void TerrainPropJob::_reset() {
 	_current_job_step = 0;
 	_current_mesh = 0;
 
+	_park_mutex.lock();
+
+	//in case the last build didn't give it back
+	_release_resources();
+
+	TerrainWorld *world = _chunk->get_voxel_world();
+
+	if (world && _prop_mesher.is_valid()) {
+		_prop_mesher_settings = _prop_mesher;
+		_prop_mesher = world->mesher_pool_borrow(_prop_mesher_settings);
+	}
+
 	if (get_prop_mesher().is_valid()) {
 		get_prop_mesher()->reset();
+		get_prop_mesher()->set_cancelled(false);
 		get_prop_mesher()->set_library(_chunk->get_library());
 	}
 
+	_park_mutex.unlock();
+
 	set_build_phase_type(BUILD_PHASE_TYPE_PHYSICS_PROCESS);
 }
 
+void TerrainPropJob::_release_resources() {
+	if (!_prop_mesher_settings.is_valid()) {
+		return;
+	}
+
+	TerrainWorld *world = _chunk.is_valid() ? _chunk->get_voxel_world() : NULL;
+
+	if (world && _prop_mesher.is_valid() && _prop_mesher != _prop_mesher_settings) {
+		world->mesher_pool_return(_prop_mesher);
+	}
+
+	_prop_mesher = _prop_mesher_settings;
+	_prop_mesher_settings.unref();
+}
+
+void TerrainPropJob::_cancel() {
+	if (get_prop_mesher().is_valid()) {
+		get_prop_mesher()->set_cancelled(true);
+	}
+}
+
 void TerrainPropJob::phase_setup() {
 	Ref<TerrainLibrary> library = _chunk->get_library();
 
-	if (!library->supports_caching()) {
+	//material caches (and their atlases) are only used for meshes
+	if (!library->supports_caching() || (_chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) == 0) {
 		next_phase();
 		return;
 	}
@@ -291,11 +345,9 @@ void TerrainPropJob::phase_setup() {
 
 		Ref<TerrainMaterialCache> cache = library->prop_material_cache_get(_chunk->prop_material_cache_key_get());
 
-		//Note: without threadpool and threading none of this can happen, as cache will get initialized the first time a thread requests it!
-		while (!cache->get_initialized()) {
-			//Means it's currently merging the atlases on a different thread.
-			//Let's just wait
-			OS::get_singleton()->delay_usec(100);
+		//it's currently merging the atlases on a different thread, this phase will run again when it's done
+		if (cache.is_valid() && !wait_for_material_cache(cache)) {
+			return;
 		}
 
 #if MESH_DATA_RESOURCE_PRESENT
@@ -448,6 +500,10 @@ void TerrainPropJob::step_type_normal() {
 
 	temp_mesh_arr = _prop_mesher->build_mesh();
 
+	if (get_cancelled()) {
+		return;
+	}
+
 	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_PROP, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
 
 	VS::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
@@ -48,6 +48,8 @@ public:
 	void _physics_process(float delta);
 	void _execute_phase();
 	void _reset();
+	void _cancel();
+	void _release_resources();
 
 	void phase_setup();
 
@@ -67,6 +69,7 @@ protected:
 	static void _bind_methods();
 
 	Ref<TerrainMesher> _prop_mesher;
+	Ref<TerrainMesher> _prop_mesher_settings;
 
 	Vector<Ref<TerrainMesherJobStep>> _job_steps;
 	int _current_job_step;
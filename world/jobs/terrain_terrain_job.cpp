@@ -30,15 +30,24 @@ SOFTWARE.
 #include "../../meshers/terrain_mesher.h"
 
 #include "../default/terrain_chunk_default.h"
+#include "../terrain_world.h"
 
 #ifdef MESH_UTILS_PRESENT
 #include "../../../mesh_utils/fast_quadratic_mesh_simplifier.h"
 #endif
 
+const int TerrainTerrainJob::MESH_CACHE_VERSION = 2;
+
 Ref<TerrainMesher> TerrainTerrainJob::get_mesher() const {
 	return _mesher;
 }
 void TerrainTerrainJob::set_mesher(const Ref<TerrainMesher> &mesher) {
+	if (_mesher_settings.is_valid()) {
+		//used from the next build
+		_mesher_settings = mesher;
+		return;
+	}
+
 	_mesher = mesher;
 }
 
@@ -46,6 +55,11 @@ Ref<TerrainMesher> TerrainTerrainJob::get_liquid_mesher() const {
 	return _liquid_mesher;
 }
 void TerrainTerrainJob::set_liquid_mesher(const Ref<TerrainMesher> &mesher) {
+	if (_liquid_mesher_settings.is_valid()) {
+		_liquid_mesher_settings = mesher;
+		return;
+	}
+
 	_liquid_mesher = mesher;
 }
 
@@ -93,7 +107,8 @@ void TerrainTerrainJob::phase_library_setup() {
 
 	Ref<TerrainLibrary> lib = _chunk->get_library();
 
-	if (!lib.is_valid()) {
+	//material caches (and their atlases) are only used for meshes
+	if (!lib.is_valid() || (_chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) == 0) {
 		next_phase();
 		return;
 	}
@@ -104,13 +119,9 @@ void TerrainTerrainJob::phase_library_setup() {
 		} else {
 			Ref<TerrainMaterialCache> cache = lib->material_cache_get(_chunk->material_cache_key_get());
 
-			if (cache.is_valid()) {
-				//Note: without threadpool and threading none of this can happen, as cache will get initialized the first time a thread requests it!
-				while (!cache->get_initialized()) {
-					//Means it's currently merging the atlases on a different thread.
-					//Let's just wait
-					OS::get_singleton()->delay_usec(100);
-				}
+			//it's currently merging the atlases on a different thread, this phase will run again when it's done
+			if (cache.is_valid() && !wait_for_material_cache(cache)) {
+				return;
 			}
 		}
 
@@ -119,13 +130,9 @@ void TerrainTerrainJob::phase_library_setup() {
 		} else {
 			Ref<TerrainMaterialCache> cache = lib->liquid_material_cache_get(_chunk->liquid_material_cache_key_get());
 
-			if (cache.is_valid()) {
-				//Note: without threadpool and threading none of this can happen, as cache will get initialized the first time a thread requests it!
-				while (!cache->get_initialized()) {
-					//Means it's currently merging the atlases on a different thread.
-					//Let's just wait
-					OS::get_singleton()->delay_usec(100);
-				}
+			//it's currently merging the atlases on a different thread, this phase will run again when it's done
+			if (cache.is_valid() && !wait_for_material_cache(cache)) {
+				return;
 			}
 		}
 	}
@@ -142,7 +149,33 @@ void TerrainTerrainJob::phase_terrain_mesh_setup() {
 		return;
 	}
 
-	if (_mesher.is_valid()) {
+	if (_chunk->get_streaming_flags() == 0) {
+		//only the data is needed
+		reset_stages();
+		next_phase();
+		return;
+	}
+
+	if (should_do()) {
+		mesh_cache_lookup();
+
+		if (should_return()) {
+			return;
+		}
+	}
+
+	if (_mesh_cache_hit) {
+		reset_stages();
+		next_phase();
+		return;
+	}
+
+	Ref<TerrainChunkDefault> chunk = _chunk;
+
+	//heightmap colliders are built straight from the channels
+	bool needs_mesh = (_chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) != 0 || !chunk.is_valid() || (chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_HEIGHTMAP_COLLIDER) == 0;
+
+	if (_mesher.is_valid() && needs_mesh) {
 		if (should_do()) {
 			_mesher->add_chunk(_chunk);
 
@@ -152,8 +185,13 @@ void TerrainTerrainJob::phase_terrain_mesh_setup() {
 		}
 	}
 
-	if (_liquid_mesher.is_valid()) {
+	//liquids only get colliders in the editor
+	if (_liquid_mesher.is_valid() && ((_chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) != 0 || Engine::get_singleton()->is_editor_hint())) {
 		_liquid_mesher->add_chunk(_chunk);
+
+		if (get_cancelled()) {
+			return;
+		}
 	}
 
 	reset_stages();
@@ -163,7 +201,9 @@ void TerrainTerrainJob::phase_terrain_mesh_setup() {
 void TerrainTerrainJob::phase_collider() {
 	Ref<TerrainChunkDefault> chunk = _chunk;
 
-	if ((chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_CREATE_COLLIDER) == 0) {
+	if ((chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_CREATE_COLLIDER) == 0 || (chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_COLLIDER) == 0) {
+		//skip phase_physics_process aswell
+		next_phase();
 		next_phase();
 		return;
 	}
@@ -175,7 +215,29 @@ void TerrainTerrainJob::phase_collider() {
 	}
 
 	if (should_do()) {
-		temp_arr_collider.append_array(_mesher->build_collider());
+		temp_heightmap_collider.clear();
+
+		if ((chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_HEIGHTMAP_COLLIDER) != 0) {
+			temp_heightmap_collider = _mesher->build_heightmap_collider(_chunk);
+		}
+
+		//chunks with holes fall back to a trimesh
+		if (temp_heightmap_collider.size() == 0) {
+			if (_mesh_cache_hit && _mesh_cache_entry.has("collider")) {
+				PoolVector<Vector3> cached = _mesh_cache_entry["collider"];
+				temp_arr_collider.append_array(cached);
+			} else {
+				if (_mesher->get_vertex_count() == 0) {
+					_mesher->add_chunk(_chunk);
+				}
+
+				temp_arr_collider.append_array(_mesher->build_collider());
+
+				if (_mesh_cache_key != "" && !_mesh_cache_hit) {
+					temp_mesh_cache_collider = temp_arr_collider;
+				}
+			}
+		}
 
 		if (should_return()) {
 			return;
@@ -188,7 +250,7 @@ void TerrainTerrainJob::phase_collider() {
 		}
 	}
 
-	if (temp_arr_collider.size() == 0 && temp_arr_collider_liquid.size() == 0) {
+	if (temp_arr_collider.size() == 0 && temp_arr_collider_liquid.size() == 0 && temp_heightmap_collider.size() == 0) {
 		reset_stages();
 		next_phase();
 		next_phase();
@@ -203,8 +265,27 @@ void TerrainTerrainJob::phase_collider() {
 void TerrainTerrainJob::phase_physics_process() {
 	Ref<TerrainChunkDefault> chunk = _chunk;
 
+	if (temp_heightmap_collider.size() != 0) {
+		colliders_ensure_shape_type(PhysicsServer::SHAPE_HEIGHTMAP);
+
+		Transform shape_transform = _mesher->get_heightmap_collider_transform(_chunk);
+
+		if (!chunk->colliders_has(TerrainChunkDefault::MESH_INDEX_TERRAIN)) {
+			chunk->colliders_create_heightmap(TerrainChunkDefault::MESH_INDEX_TERRAIN, shape_transform);
+		} else {
+			//the collider lod might have changed
+			chunk->colliders_set_shape_transform(TerrainChunkDefault::MESH_INDEX_TERRAIN, shape_transform);
+		}
+
+		PhysicsServer::get_singleton()->shape_set_data(chunk->mesh_rid_get(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_SHAPE), temp_heightmap_collider);
+
+		temp_heightmap_collider.clear();
+	}
+
 	if (temp_arr_collider.size() != 0) {
-		if (!chunk->meshes_has(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_BODY)) {
+		colliders_ensure_shape_type(PhysicsServer::SHAPE_CONCAVE_POLYGON);
+
+		if (!chunk->colliders_has(TerrainChunkDefault::MESH_INDEX_TERRAIN)) {
 			chunk->colliders_create(TerrainChunkDefault::MESH_INDEX_TERRAIN);
 		}
 
@@ -215,7 +296,7 @@ void TerrainTerrainJob::phase_physics_process() {
 
 	if (temp_arr_collider_liquid.size() != 0) {
 		if (Engine::get_singleton()->is_editor_hint()) {
-			if (!chunk->meshes_has(TerrainChunkDefault::MESH_INDEX_LIQUID, TerrainChunkDefault::MESH_TYPE_INDEX_BODY)) {
+			if (!chunk->colliders_has(TerrainChunkDefault::MESH_INDEX_LIQUID)) {
 				chunk->colliders_create(TerrainChunkDefault::MESH_INDEX_LIQUID);
 			}
 		}
@@ -236,6 +317,21 @@ void TerrainTerrainJob::phase_physics_process() {
 	next_phase();
 }
 
+//a chunk can switch between heightmap and trimesh colliders when holes appear or disappear
+void TerrainTerrainJob::colliders_ensure_shape_type(const int shape_type) {
+	Ref<TerrainChunkDefault> chunk = _chunk;
+
+	if (!chunk->meshes_has(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_SHAPE)) {
+		return;
+	}
+
+	RID shape = chunk->mesh_rid_get(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_SHAPE);
+
+	if (PhysicsServer::get_singleton()->shape_get_type(shape) != shape_type) {
+		chunk->colliders_free(TerrainChunkDefault::MESH_INDEX_TERRAIN);
+	}
+}
+
 void TerrainTerrainJob::phase_terrain_mesh() {
 	Ref<TerrainChunkDefault> chunk = _chunk;
 
@@ -245,6 +341,17 @@ void TerrainTerrainJob::phase_terrain_mesh() {
 		return;
 	}
 
+	if ((chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) == 0) {
+		reset_stages();
+		next_phase();
+		return;
+	}
+
+	if (_mesh_cache_hit) {
+		phase_terrain_mesh_cached();
+		return;
+	}
+
 	if ((chunk->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_USE_LIGHTING) != 0) {
 		//if (should_do()) {
 		//	_mesher->bake_colors(_chunk);
@@ -266,6 +373,8 @@ void TerrainTerrainJob::phase_terrain_mesh() {
 	}
 
 	if (_mesher->get_vertex_count() == 0 && (!_liquid_mesher.is_valid() || _liquid_mesher->get_vertex_count() == 0)) {
+		mesh_cache_store();
+
 		reset_stages();
 		next_phase();
 
@@ -274,63 +383,7 @@ void TerrainTerrainJob::phase_terrain_mesh() {
 
 	//set up the meshes
 	if (should_do()) {
-		RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, 0);
-
-		if (mesh_rid == RID()) {
-			//need to allocate the meshes
-
-			//first count how many we need
-			int count = 0;
-			for (int i = 0; i < _job_steps.size(); ++i) {
-				Ref<TerrainMesherJobStep> step = _job_steps[i];
-
-				ERR_FAIL_COND(!step.is_valid());
-
-				switch (step->get_job_type()) {
-					case TerrainMesherJobStep::TYPE_NORMAL:
-						++count;
-						break;
-					case TerrainMesherJobStep::TYPE_NORMAL_LOD:
-						++count;
-						break;
-					case TerrainMesherJobStep::TYPE_DROP_UV2:
-						++count;
-						break;
-					case TerrainMesherJobStep::TYPE_MERGE_VERTS:
-						++count;
-						break;
-					case TerrainMesherJobStep::TYPE_BAKE_TEXTURE:
-						++count;
-						break;
-					case TerrainMesherJobStep::TYPE_SIMPLIFY_MESH:
-#ifdef MESH_UTILS_PRESENT
-						count += step->get_simplification_steps();
-#endif
-						break;
-					default:
-						break;
-				}
-			}
-
-			//allocate
-			if (count > 0)
-				chunk->meshes_create(TerrainChunkDefault::MESH_INDEX_TERRAIN, count);
-
-		} else {
-			//we have the meshes, just clear
-			int count = chunk->mesh_rid_get_count(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH);
-
-			for (int i = 0; i < count; ++i) {
-				mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, i);
-
-				if (VS::get_singleton()->mesh_get_surface_count(mesh_rid) > 0)
-#if !GODOT4
-					VS::get_singleton()->mesh_remove_surface(mesh_rid, 0);
-#else
-					VS::get_singleton()->mesh_clear(mesh_rid);
-#endif
-			}
-		}
+		terrain_meshes_setup();
 	}
 
 	for (; _current_job_step < _job_steps.size();) {
@@ -378,14 +431,101 @@ void TerrainTerrainJob::phase_terrain_mesh() {
 			}
 		}
 
-		RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_LIQUID, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, 0);
+		liquid_mesh_add_surface(temp_mesh_arr);
+	}
 
-		if (should_do()) {
-			if (mesh_rid == RID()) {
-				chunk->meshes_create(TerrainChunkDefault::MESH_INDEX_LIQUID, 1);
+	mesh_cache_store();
+
+	reset_stages();
+	next_phase();
+}
 
-				mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_LIQUID, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, 0);
+//uploads the results of an earlier build with the same data and settings
+void TerrainTerrainJob::phase_terrain_mesh_cached() {
+	Array meshes = _mesh_cache_entry.get("meshes", Variant());
+
+	if (meshes.size() > 0) {
+		terrain_meshes_setup();
+
+		for (int i = 0; i < meshes.size(); ++i) {
+			Array arr = meshes[i];
+
+			//steps can leave their mesh empty
+			if (arr.size() > 0) {
+				terrain_mesh_add_surface(i, arr);
 			}
+		}
+	}
+
+	Array liquid = _mesh_cache_entry.get("liquid", Variant());
+
+	if (liquid.size() > 0) {
+		liquid_mesh_add_surface(liquid);
+	}
+
+	_mesh_cache_entry.clear();
+
+	reset_stages();
+	next_phase();
+}
+
+//how many meshes the steps need
+int TerrainTerrainJob::terrain_meshes_get_count() const {
+	int count = 0;
+
+	for (int i = 0; i < _job_steps.size(); ++i) {
+		Ref<TerrainMesherJobStep> step = _job_steps[i];
+
+		ERR_FAIL_COND_V(!step.is_valid(), 0);
+
+		switch (step->get_job_type()) {
+			case TerrainMesherJobStep::TYPE_NORMAL:
+				++count;
+				break;
+			case TerrainMesherJobStep::TYPE_NORMAL_LOD:
+				++count;
+				break;
+			case TerrainMesherJobStep::TYPE_DROP_UV2:
+				++count;
+				break;
+			case TerrainMesherJobStep::TYPE_MERGE_VERTS:
+				++count;
+				break;
+			case TerrainMesherJobStep::TYPE_BAKE_TEXTURE:
+				++count;
+				break;
+			case TerrainMesherJobStep::TYPE_SIMPLIFY_MESH:
+#ifdef MESH_UTILS_PRESENT
+				count += step->get_simplification_steps();
+#endif
+				break;
+			default:
+				break;
+		}
+	}
+
+	return count;
+}
+
+void TerrainTerrainJob::terrain_meshes_setup() {
+	Ref<TerrainChunkDefault> chunk = _chunk;
+
+	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, 0);
+
+	if (mesh_rid == RID()) {
+		//need to allocate the meshes
+		int count = terrain_meshes_get_count();
+
+		//allocate
+		if (count > 0)
+			chunk->meshes_create(TerrainChunkDefault::MESH_INDEX_TERRAIN, count);
+
+	} else {
+		//we have the meshes, just clear
+		int count = chunk->mesh_rid_get_count(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH);
+
+		for (int i = 0; i < count; ++i) {
+			mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, i);
 
 			if (VS::get_singleton()->mesh_get_surface_count(mesh_rid) > 0)
 #if !GODOT4
@@ -393,29 +533,215 @@ void TerrainTerrainJob::phase_terrain_mesh() {
 #else
 				VS::get_singleton()->mesh_clear(mesh_rid);
 #endif
+		}
+	}
+}
 
-			if (should_return()) {
-				return;
-			}
+void TerrainTerrainJob::terrain_mesh_add_surface(const int index, const Array &arr) {
+	Ref<TerrainChunkDefault> chunk = _chunk;
+
+	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, index);
+
+	VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, arr);
+
+	Ref<Material> lmat;
+
+	if (chunk->material_cache_key_has()) {
+		lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(index);
+	} else {
+		lmat = chunk->get_library()->material_lod_get(index);
+	}
+
+	if (lmat.is_valid()) {
+		VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
+	}
+
+	if (_mesh_cache_key != "" && !_mesh_cache_hit) {
+		if (temp_mesh_cache_meshes.size() <= index) {
+			temp_mesh_cache_meshes.resize(index + 1);
 		}
 
-		VS::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
+		//the steps keep modifying temp_mesh_arr
+		temp_mesh_cache_meshes[index] = arr.duplicate();
+	}
+}
+
+void TerrainTerrainJob::liquid_mesh_add_surface(const Array &arr) {
+	Ref<TerrainChunkDefault> chunk = _chunk;
 
-		Ref<Material> lmat;
+	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_LIQUID, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, 0);
 
-		if (chunk->liquid_material_cache_key_has()) {
-			lmat = chunk->get_library()->liquid_material_cache_get(_chunk->liquid_material_cache_key_get())->material_get(0);
-		} else {
-			lmat = chunk->get_library()->liquid_material_get(0);
+	if (mesh_rid == RID()) {
+		chunk->meshes_create(TerrainChunkDefault::MESH_INDEX_LIQUID, 1);
+
+		mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_LIQUID, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, 0);
+	}
+
+	if (VS::get_singleton()->mesh_get_surface_count(mesh_rid) > 0)
+#if !GODOT4
+		VS::get_singleton()->mesh_remove_surface(mesh_rid, 0);
+#else
+		VS::get_singleton()->mesh_clear(mesh_rid);
+#endif
+
+	VS::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, arr);
+
+	Ref<Material> lmat;
+
+	if (chunk->liquid_material_cache_key_has()) {
+		lmat = chunk->get_library()->liquid_material_cache_get(_chunk->liquid_material_cache_key_get())->material_get(0);
+	} else {
+		lmat = chunk->get_library()->liquid_material_get(0);
+	}
+
+	if (lmat.is_valid()) {
+		VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
+	}
+
+	if (_mesh_cache_key != "" && !_mesh_cache_hit) {
+		temp_mesh_cache_liquid = arr;
+	}
+}
+
+//everything that ends up in the meshes: the channels, the build flags, the world height, the materials, the library and the mesher / step settings
+String TerrainTerrainJob::mesh_cache_get_key() const {
+	Ref<TerrainChunkDefault> chunk = _chunk;
+
+	Array settings;
+	settings.push_back(chunk.is_valid() ? chunk->get_build_flags() : 0);
+	settings.push_back(_chunk->get_size_x());
+	settings.push_back(_chunk->get_size_z());
+	settings.push_back(_chunk->get_margin_start());
+	settings.push_back(_chunk->get_margin_end());
+	settings.push_back(_chunk->get_voxel_scale());
+	settings.push_back(_chunk->get_world_height());
+
+	//the material cache keys are set in phase_library_setup(), the surfaces get their materials from them
+	settings.push_back(_chunk->material_cache_key_has() ? _chunk->material_cache_key_get() : -1);
+	settings.push_back(_chunk->liquid_material_cache_key_has() ? _chunk->liquid_material_cache_key_get() : -1);
+
+	Ref<TerrainLibrary> lib = _chunk->get_library();
+
+	if (lib.is_valid()) {
+		settings.push_back(lib->get_class());
+		settings.push_back(lib->get_path());
+		settings.push_back(lib->get_revision());
+	}
+
+	Vector<Object *> objects;
+	objects.push_back(_mesher_settings.is_valid() ? _mesher_settings.ptr() : _mesher.ptr());
+	objects.push_back(_liquid_mesher_settings.is_valid() ? _liquid_mesher_settings.ptr() : _liquid_mesher.ptr());
+
+	for (int i = 0; i < _job_steps.size(); ++i) {
+		objects.push_back(_job_steps[i].ptr());
+	}
+
+	for (int i = 0; i < objects.size(); ++i) {
+		Object *obj = objects[i];
+
+		if (!obj) {
+			settings.push_back(Variant());
+			continue;
 		}
 
-		if (lmat.is_valid()) {
-			VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
+		settings.push_back(obj->get_class());
+
+		List<PropertyInfo> properties;
+		obj->get_property_list(&properties);
+
+		for (List<PropertyInfo>::Element *E = properties.front(); E; E = E->next()) {
+			const PropertyInfo &p = E->get();
+
+			//objects would only hash their address
+			if ((p.usage & PROPERTY_USAGE_STORAGE) == 0 || p.type == Variant::OBJECT || p.name == "script") {
+				continue;
+			}
+
+			//the steps set it on the meshers while building
+			if (i < 2 && p.name == "lod_index") {
+				continue;
+			}
+
+			settings.push_back(obj->get(p.name));
 		}
 	}
 
-	reset_stages();
-	next_phase();
+	uint32_t settings_hash = settings.hash();
+
+	uint64_t h = TerrainChunk::hash_buffer(reinterpret_cast<const uint8_t *>(&settings_hash), sizeof(settings_hash), _chunk->get_data_hash());
+
+	return String::num_uint64(h, 16);
+}
+
+void TerrainTerrainJob::mesh_cache_lookup() {
+	_mesh_cache_key = "";
+	_mesh_cache_hit = false;
+	_mesh_cache_entry.clear();
+
+	TerrainWorld *world = _chunk->get_voxel_world();
+
+	//collider only builds are cheap enough without it
+	if (!world || !world->mesh_cache_is_enabled() || (_chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_RENDER) == 0) {
+		return;
+	}
+
+	_mesh_cache_key = mesh_cache_get_key();
+
+	Dictionary entry = world->mesh_cache_load(_mesh_cache_key);
+
+	if (static_cast<int>(entry.get("version", 0)) != MESH_CACHE_VERSION) {
+		return;
+	}
+
+	//mesh_cache_load() already checked the arrays, an entry for a different step setup would index meshes that don't exist
+	Array meshes = entry.get("meshes", Variant());
+
+	if (meshes.size() != terrain_meshes_get_count()) {
+		return;
+	}
+
+	_mesh_cache_entry = entry;
+	_mesh_cache_hit = true;
+}
+
+void TerrainTerrainJob::mesh_cache_store() {
+	if (_mesh_cache_key == "" || _mesh_cache_hit || get_cancelled()) {
+		return;
+	}
+
+	TerrainWorld *world = _chunk->get_voxel_world();
+
+	if (!world) {
+		return;
+	}
+
+	Dictionary entry;
+	entry["version"] = MESH_CACHE_VERSION;
+	//one entry for every mesh terrain_meshes_setup() creates, the ones the steps left empty included
+	temp_mesh_cache_meshes.resize(terrain_meshes_get_count());
+
+	for (int i = 0; i < temp_mesh_cache_meshes.size(); ++i) {
+		if (temp_mesh_cache_meshes[i].get_type() != Variant::ARRAY) {
+			temp_mesh_cache_meshes[i] = Array();
+		}
+	}
+
+	entry["meshes"] = temp_mesh_cache_meshes;
+
+	if (temp_mesh_cache_liquid.size() > 0) {
+		entry["liquid"] = temp_mesh_cache_liquid;
+	}
+
+	if (temp_mesh_cache_collider.size() > 0) {
+		entry["collider"] = temp_mesh_cache_collider;
+	}
+
+	world->mesh_cache_store(_mesh_cache_key, entry);
+
+	_mesh_cache_key = "";
+	temp_mesh_cache_meshes.clear();
+	temp_mesh_cache_liquid.clear();
+	temp_mesh_cache_collider.resize(0);
 }
 
 void TerrainTerrainJob::phase_finalize() {
@@ -459,8 +785,34 @@ void TerrainTerrainJob::_reset() {
 	_current_job_step = 0;
 	_current_mesh = 0;
 
+	_mesh_cache_key = "";
+	_mesh_cache_hit = false;
+	_mesh_cache_entry.clear();
+	temp_mesh_cache_meshes.clear();
+	temp_mesh_cache_liquid.clear();
+	temp_mesh_cache_collider.resize(0);
+
+	MutexLock lock(_park_mutex);
+
+	//in case the last build didn't give them back
+	_release_resources();
+
 	ERR_FAIL_COND(!_mesher.is_valid());
 
+	//the meshers set on the job only hold the settings while building
+	TerrainWorld *world = _chunk->get_voxel_world();
+
+	if (world) {
+		_mesher_settings = _mesher;
+		_mesher = world->mesher_pool_borrow(_mesher_settings);
+
+		if (_liquid_mesher.is_valid()) {
+			_liquid_mesher_settings = _liquid_mesher;
+			_liquid_mesher = world->mesher_pool_borrow(_liquid_mesher_settings);
+		}
+	}
+
+	_mesher->set_cancelled(false);
 	_mesher->set_voxel_scale(_chunk->get_voxel_scale());
 
 	Ref<TerrainChunkDefault> chunk = _chunk;
@@ -471,6 +823,7 @@ void TerrainTerrainJob::_reset() {
 	}
 
 	if (_liquid_mesher.is_valid()) {
+		_liquid_mesher->set_cancelled(false);
 		_liquid_mesher->set_voxel_scale(_chunk->get_voxel_scale());
 
 		md = _liquid_mesher;
@@ -481,6 +834,38 @@ void TerrainTerrainJob::_reset() {
 	}
 }
 
+void TerrainTerrainJob::_cancel() {
+	if (_mesher.is_valid()) {
+		_mesher->set_cancelled(true);
+	}
+
+	if (_liquid_mesher.is_valid()) {
+		_liquid_mesher->set_cancelled(true);
+	}
+}
+
+void TerrainTerrainJob::_release_resources() {
+	TerrainWorld *world = _chunk.is_valid() ? _chunk->get_voxel_world() : NULL;
+
+	if (_mesher_settings.is_valid()) {
+		if (world && _mesher.is_valid() && _mesher != _mesher_settings) {
+			world->mesher_pool_return(_mesher);
+		}
+
+		_mesher = _mesher_settings;
+		_mesher_settings.unref();
+	}
+
+	if (_liquid_mesher_settings.is_valid()) {
+		if (world && _liquid_mesher.is_valid() && _liquid_mesher != _liquid_mesher_settings) {
+			world->mesher_pool_return(_liquid_mesher);
+		}
+
+		_liquid_mesher = _liquid_mesher_settings;
+		_liquid_mesher_settings.unref();
+	}
+}
+
 void TerrainTerrainJob::_physics_process(float delta) {
 	if (_phase == 4)
 		phase_physics_process();
@@ -496,21 +881,11 @@ void TerrainTerrainJob::step_type_normal() {
 
 	temp_mesh_arr = _mesher->build_mesh();
 
-	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
-
-	VS::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
-
-	Ref<Material> lmat;
-
-	if (chunk->material_cache_key_has()) {
-		lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(_current_mesh);
-	} else {
-		lmat = chunk->get_library()->material_lod_get(_current_mesh);
+	if (get_cancelled()) {
+		return;
 	}
 
-	if (lmat.is_valid()) {
-		VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
-	}
+	terrain_mesh_add_surface(_current_mesh, temp_mesh_arr);
 
 	++_current_mesh;
 }
@@ -533,45 +908,19 @@ void TerrainTerrainJob::step_type_normal_lod() {
 
 	temp_mesh_arr = _mesher->build_mesh();
 
-	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
-
-	VS::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
-
-	Ref<Material> lmat;
-
-	if (chunk->material_cache_key_has()) {
-		lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(_current_mesh);
-	} else {
-		lmat = chunk->get_library()->material_lod_get(_current_mesh);
+	if (get_cancelled()) {
+		return;
 	}
 
-	if (lmat.is_valid()) {
-		VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
-	}
+	terrain_mesh_add_surface(_current_mesh, temp_mesh_arr);
 
 	++_current_mesh;
 }
 
 void TerrainTerrainJob::step_type_drop_uv2() {
-	Ref<TerrainChunkDefault> chunk = _chunk;
-
-	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
-
 	temp_mesh_arr[VisualServer::ARRAY_TEX_UV2] = Variant();
 
-	VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
-
-	Ref<Material> lmat;
-
-	if (chunk->material_cache_key_has()) {
-		lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(_current_mesh);
-	} else {
-		lmat = chunk->get_library()->material_lod_get(_current_mesh);
-	}
-
-	if (lmat.is_valid()) {
-		VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
-	}
+	terrain_mesh_add_surface(_current_mesh, temp_mesh_arr);
 
 	++_current_mesh;
 }
@@ -580,22 +929,7 @@ void TerrainTerrainJob::step_type_merge_verts() {
 	Array temp_mesh_arr2 = merge_mesh_array(temp_mesh_arr);
 	temp_mesh_arr = temp_mesh_arr2;
 
-	Ref<TerrainChunkDefault> chunk = _chunk;
-	RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
-
-	VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
-
-	Ref<Material> lmat;
-
-	if (chunk->material_cache_key_has()) {
-		lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(_current_mesh);
-	} else {
-		lmat = chunk->get_library()->material_lod_get(_current_mesh);
-	}
-
-	if (lmat.is_valid()) {
-		VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
-	}
+	terrain_mesh_add_surface(_current_mesh, temp_mesh_arr);
 
 	++_current_mesh;
 }
@@ -617,21 +951,7 @@ void TerrainTerrainJob::step_type_bake_texture() {
 		temp_mesh_arr = bake_mesh_array_uv(temp_mesh_arr, tex);
 		temp_mesh_arr[VisualServer::ARRAY_TEX_UV] = Variant();
 
-		RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
-
-		VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
-
-		Ref<Material> lmat;
-
-		if (chunk->material_cache_key_has()) {
-			lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(_current_mesh);
-		} else {
-			lmat = chunk->get_library()->material_lod_get(_current_mesh);
-		}
-
-		if (lmat.is_valid()) {
-			VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
-		}
+		terrain_mesh_add_surface(_current_mesh, temp_mesh_arr);
 	}
 
 	++_current_mesh;
@@ -640,7 +960,6 @@ void TerrainTerrainJob::step_type_bake_texture() {
 void TerrainTerrainJob::step_type_simplify_mesh() {
 #ifdef MESH_UTILS_PRESENT
 
-	Ref<TerrainChunkDefault> chunk = _chunk;
 	Ref<TerrainMesherJobStep> step = _job_steps[_current_job_step];
 	ERR_FAIL_COND(!step.is_valid());
 	Ref<FastQuadraticMeshSimplifier> fqms = step->get_fqms();
@@ -652,21 +971,7 @@ void TerrainTerrainJob::step_type_simplify_mesh() {
 		fqms->simplify_mesh(temp_mesh_arr.size() * step->get_simplification_step_ratio(), step->get_simplification_agressiveness());
 		temp_mesh_arr = fqms->get_arrays();
 
-		RID mesh_rid = chunk->mesh_rid_get_index(TerrainChunkDefault::MESH_INDEX_TERRAIN, TerrainChunkDefault::MESH_TYPE_INDEX_MESH, _current_mesh);
-
-		VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh_rid, VisualServer::PRIMITIVE_TRIANGLES, temp_mesh_arr);
-
-		Ref<Material> lmat;
-
-		if (chunk->material_cache_key_has()) {
-			lmat = chunk->get_library()->material_cache_get(_chunk->material_cache_key_get())->material_lod_get(_current_mesh);
-		} else {
-			lmat = chunk->get_library()->material_lod_get(_current_mesh);
-		}
-
-		if (lmat.is_valid()) {
-			VisualServer::get_singleton()->mesh_surface_set_material(mesh_rid, 0, lmat->get_rid());
-		}
+		terrain_mesh_add_surface(_current_mesh, temp_mesh_arr);
 
 		++_current_mesh;
 	}
@@ -677,6 +982,7 @@ void TerrainTerrainJob::step_type_simplify_mesh() {
 TerrainTerrainJob::TerrainTerrainJob() {
 	_current_job_step = 0;
 	_current_mesh = 0;
+	_mesh_cache_hit = false;
 }
 
 TerrainTerrainJob::~TerrainTerrainJob() {
@@ -39,6 +39,8 @@ class TerrainTerrainJob : public TerrainJob {
 	GDCLASS(TerrainTerrainJob, TerrainJob);
 
 public:
+	static const int MESH_CACHE_VERSION;
+
 	Ref<TerrainMesher> get_mesher() const;
 	void set_mesher(const Ref<TerrainMesher> &mesher);
 
@@ -56,12 +58,25 @@ public:
 	void phase_terrain_mesh_setup();
 	void phase_collider();
 	void phase_physics_proces();
+	void colliders_ensure_shape_type(const int shape_type);
 	void phase_terrain_mesh();
+	void phase_terrain_mesh_cached();
 	void phase_finalize();
 	void phase_physics_process();
 
+	int terrain_meshes_get_count() const;
+	void terrain_meshes_setup();
+	void terrain_mesh_add_surface(const int index, const Array &arr);
+	void liquid_mesh_add_surface(const Array &arr);
+
+	String mesh_cache_get_key() const;
+	void mesh_cache_lookup();
+	void mesh_cache_store();
+
 	void _execute_phase();
 	void _reset();
+	void _cancel();
+	void _release_resources();
 	void _physics_process(float delta);
 
 	void step_type_normal();
@@ -80,13 +95,26 @@ protected:
 	Ref<TerrainMesher> _mesher;
 	Ref<TerrainMesher> _liquid_mesher;
 
+	//the meshers that were set on the job while borrowed ones are in use
+	Ref<TerrainMesher> _mesher_settings;
+	Ref<TerrainMesher> _liquid_mesher_settings;
+
 	Vector<Ref<TerrainMesherJobStep> > _job_steps;
 	int _current_job_step;
 	int _current_mesh;
 
 	PoolVector<Vector3> temp_arr_collider;
 	PoolVector<Vector3> temp_arr_collider_liquid;
+	Dictionary temp_heightmap_collider;
 	Array temp_mesh_arr;
+
+	//the key is only set when the world has a mesh cache, on a miss the results are collected for it
+	String _mesh_cache_key;
+	bool _mesh_cache_hit;
+	Dictionary _mesh_cache_entry;
+	Array temp_mesh_cache_meshes;
+	Array temp_mesh_cache_liquid;
+	PoolVector<Vector3> temp_mesh_cache_collider;
 };
 
 #endif
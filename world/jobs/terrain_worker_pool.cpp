@@ -0,0 +1,250 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "terrain_worker_pool.h"
+
+void TerrainWorkerPool::start(const int thread_count) {
+	ERR_FAIL_COND(is_running());
+	ERR_FAIL_COND(thread_count <= 0);
+
+	_exit.clear();
+
+	for (int i = 0; i < thread_count; ++i) {
+		Worker *worker = memnew(Worker);
+		worker->pool = this;
+		worker->index = i;
+
+		_workers.push_back(worker);
+	}
+
+	//only start the threads after the workers vector is final, as they read it while stealing
+	for (int i = 0; i < _workers.size(); ++i) {
+		_workers[i]->thread.start(_worker_thread_func, _workers[i]);
+	}
+}
+void TerrainWorkerPool::stop() {
+	if (!is_running()) {
+		return;
+	}
+
+	_exit.set();
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		_semaphore.post();
+	}
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		_workers[i]->thread.wait_to_finish();
+	}
+
+	//jobs that never ran are dropped, their chunks are cancelled by the time the pool stops
+	for (int i = 0; i < _workers.size(); ++i) {
+		Worker *worker = _workers[i];
+
+		for (List<Ref<TerrainJob>>::Element *E = worker->queue.front(); E; E = E->next()) {
+			E->get()->set_cancelled(true);
+		}
+
+		worker->queue.clear();
+
+		memdelete(worker);
+	}
+
+	_workers.clear();
+
+	_completed_mutex.lock();
+	_completed.clear();
+	_completed_mutex.unlock();
+}
+bool TerrainWorkerPool::is_running() const {
+	return _workers.size() > 0;
+}
+int TerrainWorkerPool::get_thread_count() const {
+	return _workers.size();
+}
+
+void TerrainWorkerPool::add_job(const Ref<TerrainJob> &job) {
+	ERR_FAIL_COND(!job.is_valid());
+	ERR_FAIL_COND(!is_running());
+
+	//jobs queued from a worker stay on it, everything else is spread around
+	int index = get_caller_worker_index();
+
+	if (index == -1) {
+		index = _next_worker++ % _workers.size();
+	}
+
+	Worker *worker = _workers[index];
+
+	worker->mutex.lock();
+	worker->queue.push_back(job);
+	worker->mutex.unlock();
+
+	_semaphore.post();
+}
+bool TerrainWorkerPool::has_job(const Ref<TerrainJob> &job) {
+	for (int i = 0; i < _workers.size(); ++i) {
+		Worker *worker = _workers[i];
+
+		MutexLock lock(worker->mutex);
+
+		if (worker->current == job) {
+			return true;
+		}
+
+		for (List<Ref<TerrainJob>>::Element *E = worker->queue.front(); E; E = E->next()) {
+			if (E->get() == job) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+//returns true if the job was still queued, in that case it won't run at all
+bool TerrainWorkerPool::cancel_job(const Ref<TerrainJob> &job) {
+	ERR_FAIL_COND_V(!job.is_valid(), false);
+
+	job->set_cancelled(true);
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		Worker *worker = _workers[i];
+
+		MutexLock lock(worker->mutex);
+
+		if (worker->queue.erase(job)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TerrainWorkerPool::process_completed() {
+	List<Ref<TerrainJob>> completed;
+
+	_completed_mutex.lock();
+
+	for (List<Ref<TerrainJob>>::Element *E = _completed.front(); E; E = E->next()) {
+		completed.push_back(E->get());
+	}
+
+	_completed.clear();
+	_completed_mutex.unlock();
+
+	for (List<Ref<TerrainJob>>::Element *E = completed.front(); E; E = E->next()) {
+		E->get()->emit_signal("completed");
+	}
+}
+
+void TerrainWorkerPool::_worker_thread_func(void *p_user_data) {
+	Worker *worker = reinterpret_cast<Worker *>(p_user_data);
+
+	worker->pool->worker_loop(worker);
+}
+
+void TerrainWorkerPool::worker_loop(Worker *worker) {
+	while (true) {
+		Ref<TerrainJob> job = worker_pop(worker);
+
+		if (!job.is_valid()) {
+			job = worker_steal(worker);
+		}
+
+		if (!job.is_valid()) {
+			if (_exit.is_set()) {
+				return;
+			}
+
+			_semaphore.wait();
+			continue;
+		}
+
+		worker->mutex.lock();
+		worker->current = job;
+		worker->mutex.unlock();
+
+		//jobs that got cancelled after they were popped still run, they hand themselves back to their chunk right away
+		job->execute();
+
+		if (!job->get_cancelled()) {
+			_completed_mutex.lock();
+			_completed.push_back(job);
+			_completed_mutex.unlock();
+		}
+
+		worker->mutex.lock();
+		worker->current.unref();
+		worker->mutex.unlock();
+	}
+}
+Ref<TerrainJob> TerrainWorkerPool::worker_pop(Worker *worker) {
+	MutexLock lock(worker->mutex);
+
+	if (worker->queue.empty()) {
+		return Ref<TerrainJob>();
+	}
+
+	Ref<TerrainJob> job = worker->queue.back()->get();
+	worker->queue.pop_back();
+
+	return job;
+}
+Ref<TerrainJob> TerrainWorkerPool::worker_steal(Worker *worker) {
+	int count = _workers.size();
+
+	for (int i = 1; i < count; ++i) {
+		Worker *victim = _workers[(worker->index + i) % count];
+
+		MutexLock lock(victim->mutex);
+
+		if (victim->queue.empty()) {
+			continue;
+		}
+
+		Ref<TerrainJob> job = victim->queue.front()->get();
+		victim->queue.pop_front();
+
+		return job;
+	}
+
+	return Ref<TerrainJob>();
+}
+int TerrainWorkerPool::get_caller_worker_index() const {
+	Thread::ID caller = Thread::get_caller_id();
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		if (_workers[i]->thread.get_id() == caller) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+TerrainWorkerPool::TerrainWorkerPool() {
+	_next_worker = 0;
+}
+
+TerrainWorkerPool::~TerrainWorkerPool() {
+	stop();
+}
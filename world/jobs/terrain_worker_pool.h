@@ -0,0 +1,90 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef TERRAIN_WORKER_POOL_H
+#define TERRAIN_WORKER_POOL_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/templates/list.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/vector.h"
+#else
+#include "core/list.h"
+#include "core/safe_refcount.h"
+#include "core/vector.h"
+#endif
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+#include "terrain_job.h"
+
+//Small work stealing pool, used to run TerrainJobs when the thread_pool module is not present.
+//Every worker has its own deque, it pops from the back of its own and steals from the front of the others.
+//Finished jobs are collected, and process_completed() emits their completed signal on the main thread.
+//Cancelled jobs don't get a completed signal.
+class TerrainWorkerPool {
+public:
+	void start(const int thread_count);
+	void stop();
+	bool is_running() const;
+	int get_thread_count() const;
+
+	void add_job(const Ref<TerrainJob> &job);
+	bool has_job(const Ref<TerrainJob> &job);
+	bool cancel_job(const Ref<TerrainJob> &job);
+
+	void process_completed();
+
+	TerrainWorkerPool();
+	~TerrainWorkerPool();
+
+protected:
+	struct Worker {
+		TerrainWorkerPool *pool;
+		int index;
+		Thread thread;
+		Mutex mutex;
+		List<Ref<TerrainJob>> queue;
+		Ref<TerrainJob> current;
+	};
+
+	static void _worker_thread_func(void *p_user_data);
+
+	void worker_loop(Worker *worker);
+	Ref<TerrainJob> worker_pop(Worker *worker);
+	Ref<TerrainJob> worker_steal(Worker *worker);
+	int get_caller_worker_index() const;
+
+	Vector<Worker *> _workers;
+	uint32_t _next_worker;
+	Semaphore _semaphore;
+	SafeFlag _exit;
+
+	Mutex _completed_mutex;
+	List<Ref<TerrainJob>> _completed;
+};
+
+#endif
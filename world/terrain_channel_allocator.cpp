@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "terrain_channel_allocator.h"
+
+Mutex TerrainChannelAllocator::_mutex;
+Vector<TerrainChannelAllocator::FreeList> TerrainChannelAllocator::_free_lists;
+uint8_t *TerrainChannelAllocator::_uniform_blocks[256] = {};
+uint32_t TerrainChannelAllocator::_uniform_block_sizes[256] = {};
+Vector<uint8_t *> TerrainChannelAllocator::_retired_uniform_blocks;
+
+uint8_t *TerrainChannelAllocator::alloc(const uint32_t size) {
+	ERR_FAIL_COND_V(size == 0, NULL);
+
+	uint32_t block_size = align(size);
+
+	_mutex.lock();
+
+	int index = get_free_list(block_size);
+
+	if (index != -1) {
+		Vector<uint8_t *> &blocks = _free_lists.write[index].blocks;
+
+		if (blocks.size() > 0) {
+			uint8_t *ptr = blocks[blocks.size() - 1];
+			blocks.resize(blocks.size() - 1);
+
+			_mutex.unlock();
+
+			return ptr;
+		}
+	}
+
+	_mutex.unlock();
+
+	return alloc_aligned(block_size);
+}
+//size has to be the same that was passed to alloc()
+void TerrainChannelAllocator::free(uint8_t *ptr, const uint32_t size) {
+	if (!ptr) {
+		return;
+	}
+
+	uint32_t block_size = align(size);
+
+	_mutex.lock();
+
+	int index = get_free_list(block_size);
+
+	if (index == -1 && _free_lists.size() < MAX_FREE_LISTS) {
+		FreeList list;
+		list.size = block_size;
+		_free_lists.push_back(list);
+
+		index = _free_lists.size() - 1;
+	}
+
+	if (index != -1) {
+		Vector<uint8_t *> &blocks = _free_lists.write[index].blocks;
+
+		if (blocks.size() < MAX_FREE_BLOCKS_PER_LIST) {
+			blocks.push_back(ptr);
+
+			_mutex.unlock();
+			return;
+		}
+	}
+
+	_mutex.unlock();
+
+	free_aligned(ptr);
+}
+
+//what alloc() actually reserves for a size
+uint32_t TerrainChannelAllocator::get_block_size(const uint32_t size) {
+	return align(size);
+}
+uint32_t TerrainChannelAllocator::align(const uint32_t size) {
+	return (size + ALIGNMENT - 1) & ~static_cast<uint32_t>(ALIGNMENT - 1);
+}
+
+//the blocks only ever grow, outgrown ones are kept until clear(), as other threads might still read them
+const uint8_t *TerrainChannelAllocator::get_uniform_block(const uint8_t value, const uint32_t size) {
+	ERR_FAIL_COND_V(size == 0, NULL);
+
+	MutexLock lock(_mutex);
+
+	if (_uniform_block_sizes[value] >= size) {
+		return _uniform_blocks[value];
+	}
+
+	if (_uniform_blocks[value]) {
+		_retired_uniform_blocks.push_back(_uniform_blocks[value]);
+	}
+
+	uint32_t block_size = align(size);
+
+	uint8_t *ptr = alloc_aligned(block_size);
+	memset(ptr, value, block_size);
+
+	_uniform_blocks[value] = ptr;
+	_uniform_block_sizes[value] = block_size;
+
+	return ptr;
+}
+
+int TerrainChannelAllocator::get_free_block_count() {
+	MutexLock lock(_mutex);
+
+	int count = 0;
+
+	for (int i = 0; i < _free_lists.size(); ++i) {
+		count += _free_lists[i].blocks.size();
+	}
+
+	return count;
+}
+void TerrainChannelAllocator::clear() {
+	MutexLock lock(_mutex);
+
+	for (int i = 0; i < _free_lists.size(); ++i) {
+		const Vector<uint8_t *> &blocks = _free_lists[i].blocks;
+
+		for (int j = 0; j < blocks.size(); ++j) {
+			free_aligned(blocks[j]);
+		}
+	}
+
+	_free_lists.clear();
+
+	for (int i = 0; i < 256; ++i) {
+		if (_uniform_blocks[i]) {
+			free_aligned(_uniform_blocks[i]);
+		}
+
+		_uniform_blocks[i] = NULL;
+		_uniform_block_sizes[i] = 0;
+	}
+
+	for (int i = 0; i < _retired_uniform_blocks.size(); ++i) {
+		free_aligned(_retired_uniform_blocks[i]);
+	}
+
+	_retired_uniform_blocks.clear();
+}
+
+//-1 if there is no list for the size yet, has to be called with the mutex locked
+int TerrainChannelAllocator::get_free_list(const uint32_t block_size) {
+	for (int i = 0; i < _free_lists.size(); ++i) {
+		if (_free_lists[i].size == block_size) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+//the offset to the start of the real allocation is stored in the byte right before the returned pointer
+uint8_t *TerrainChannelAllocator::alloc_aligned(const uint32_t size) {
+	uint8_t *raw = reinterpret_cast<uint8_t *>(memalloc(size + ALIGNMENT));
+
+	ERR_FAIL_COND_V(!raw, NULL);
+
+	uint8_t *ptr = reinterpret_cast<uint8_t *>((reinterpret_cast<uintptr_t>(raw) + ALIGNMENT) & ~static_cast<uintptr_t>(ALIGNMENT - 1));
+
+	ptr[-1] = static_cast<uint8_t>(ptr - raw);
+
+	return ptr;
+}
+void TerrainChannelAllocator::free_aligned(uint8_t *ptr) {
+	memfree(ptr - ptr[-1]);
+}
@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef TERRAIN_CHANNEL_ALLOCATOR_H
+#define TERRAIN_CHANNEL_ALLOCATOR_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/templates/vector.h"
+#else
+#include "core/vector.h"
+#endif
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+
+//Allocates the channel buffers of the chunks.
+//Blocks are 64 byte aligned, and freed blocks go to a free list per (aligned) size. Every chunk of a world has the same size,
+//so chunks that stream in and out keep reusing the same memory instead of going through the system allocator.
+//It also keeps one read only block per byte value, these are handed out for channels that are filled with a single value.
+class TerrainChannelAllocator {
+public:
+	enum {
+		ALIGNMENT = 64,
+		MAX_FREE_LISTS = 8,
+		MAX_FREE_BLOCKS_PER_LIST = 1024,
+	};
+
+	static uint8_t *alloc(const uint32_t size);
+	static void free(uint8_t *ptr, const uint32_t size);
+
+	static uint32_t get_block_size(const uint32_t size);
+	static uint32_t align(const uint32_t size);
+
+	static const uint8_t *get_uniform_block(const uint8_t value, const uint32_t size);
+
+	static int get_free_block_count();
+	static void clear();
+
+protected:
+	struct FreeList {
+		uint32_t size;
+		Vector<uint8_t *> blocks;
+	};
+
+	static int get_free_list(const uint32_t block_size);
+
+	static uint8_t *alloc_aligned(const uint32_t size);
+	static void free_aligned(uint8_t *ptr);
+
+	static Mutex _mutex;
+	static Vector<FreeList> _free_lists;
+
+	static uint8_t *_uniform_blocks[256];
+	static uint32_t _uniform_block_sizes[256];
+	static Vector<uint8_t *> _retired_uniform_blocks;
+};
+
+#endif
@@ -0,0 +1,365 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "terrain_channel_codec.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+
+#include "../thirdparty/lz4/lz4.h"
+
+PoolByteArray TerrainChannelCodec::encode(const uint8_t *data, const int size, const int width, const int filter, const int codec) {
+	ERR_FAIL_COND_V(!data || size <= 0 || width <= 0, PoolByteArray());
+	ERR_FAIL_INDEX_V(filter, FILTER_MAX, PoolByteArray());
+	ERR_FAIL_INDEX_V(codec, CODEC_MAX, PoolByteArray());
+
+	if (filter == FILTER_NONE) {
+		return compress_with_header(data, size, size, filter, codec, 0);
+	}
+
+	Vector<uint8_t> filtered;
+	filtered.resize(size);
+	memcpy(filtered.ptrw(), data, size);
+
+	filter_apply(filtered.ptrw(), size, width, filter);
+
+	return compress_with_header(filtered.ptr(), size, size, filter, codec, 0);
+}
+
+//the payload is the bit count, the id count, the ids, and then the packed indices
+PoolByteArray TerrainChannelCodec::encode_palette(const uint8_t *ids, const int id_count, const uint8_t *indices, const int bits, const int size, const int codec) {
+	ERR_FAIL_COND_V(!ids || !indices || size <= 0, PoolByteArray());
+	ERR_FAIL_COND_V(bits != 1 && bits != 2 && bits != 4, PoolByteArray());
+	ERR_FAIL_COND_V(id_count <= 0 || id_count > (1 << bits), PoolByteArray());
+	ERR_FAIL_INDEX_V(codec, CODEC_MAX, PoolByteArray());
+
+	int indices_size = (size * bits + 7) / 8;
+
+	Vector<uint8_t> payload;
+	payload.resize(2 + id_count + indices_size);
+
+	uint8_t *w = payload.ptrw();
+	w[0] = bits;
+	w[1] = id_count;
+	memcpy(w + 2, ids, id_count);
+	memcpy(w + 2 + id_count, indices, indices_size);
+
+	return compress_with_header(payload.ptr(), payload.size(), size, FILTER_NONE, codec, FLAG_PALETTE);
+}
+
+PoolByteArray TerrainChannelCodec::compress_with_header(const uint8_t *src, const int src_size, const int original_size, const int filter, const int codec, const int flags) {
+	PoolByteArray arr;
+
+	int bound = get_max_compressed_size(src_size, codec);
+	arr.resize(HEADER_SIZE + bound);
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+	uint8_t *dst = w.ptr();
+#else
+	uint8_t *dst = arr.ptrw();
+#endif
+
+	dst[0] = 'T';
+	dst[1] = 'C';
+	dst[2] = 'C';
+	dst[3] = VERSION;
+	dst[4] = filter;
+	dst[5] = codec;
+	dst[6] = flags;
+	dst[7] = 0;
+	encode_uint32(original_size, &dst[8]);
+
+	int ns = compress(src, src_size, dst + HEADER_SIZE, bound, codec);
+
+#if !GODOT4
+	w.release();
+#endif
+
+	ERR_FAIL_COND_V_MSG(ns < 0, PoolByteArray(), "TerrainChannelCodec: Compression failed!");
+
+	arr.resize(HEADER_SIZE + ns);
+
+	return arr;
+}
+
+//r_data has to have room for size bytes, size is what the caller expects, the header has to match it
+bool TerrainChannelCodec::decode(const PoolByteArray &data, uint8_t *r_data, const int size, const int width) {
+	ERR_FAIL_COND_V(!r_data || size <= 0 || width <= 0, false);
+
+	int ds = data.size();
+
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	const uint8_t *src = r.ptr();
+#else
+	const uint8_t *src = data.ptr();
+#endif
+
+	//data saved before the header was added is a plain lz4 block
+	if (!has_header(data)) {
+		int ns = LZ4_decompress_safe(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(r_data), ds, size);
+
+		ERR_FAIL_COND_V_MSG(ns != size, false, "TerrainChannelCodec: Corrupt data! Decompressed size: " + itos(ns) + ", expected: " + itos(size));
+
+		return true;
+	}
+
+	ERR_FAIL_COND_V_MSG(src[3] != VERSION, false, "TerrainChannelCodec: Unknown version: " + itos(src[3]));
+
+	int filter = src[4];
+	int codec = src[5];
+
+	ERR_FAIL_INDEX_V_MSG(filter, FILTER_MAX, false, "TerrainChannelCodec: Unknown filter: " + itos(filter));
+	ERR_FAIL_INDEX_V_MSG(codec, CODEC_MAX, false, "TerrainChannelCodec: Unknown codec: " + itos(codec));
+
+	uint32_t original_size = decode_uint32(&src[8]);
+
+	ERR_FAIL_COND_V_MSG(original_size != static_cast<uint32_t>(size), false, "TerrainChannelCodec: Size mismatch! Data size: " + itos(original_size) + ", expected: " + itos(size));
+
+	if ((src[6] & FLAG_PALETTE) != 0) {
+		return decode_palette(src + HEADER_SIZE, ds - HEADER_SIZE, r_data, size, codec);
+	}
+
+	int ns = decompress(src + HEADER_SIZE, ds - HEADER_SIZE, r_data, size, codec);
+
+	ERR_FAIL_COND_V_MSG(ns != size, false, "TerrainChannelCodec: Corrupt data! Decompressed size: " + itos(ns) + ", expected: " + itos(size));
+
+	filter_revert(r_data, size, width, filter);
+
+	return true;
+}
+
+bool TerrainChannelCodec::decode_palette(const uint8_t *src, const int src_size, uint8_t *r_data, const int size, const int codec) {
+	int max_payload_size = 2 + 16 + (size * 4 + 7) / 8;
+
+	Vector<uint8_t> payload;
+	payload.resize(max_payload_size);
+
+	int ns = decompress(src, src_size, payload.ptrw(), max_payload_size, codec);
+
+	ERR_FAIL_COND_V_MSG(ns < 2, false, "TerrainChannelCodec: Corrupt palette data!");
+
+	const uint8_t *p = payload.ptr();
+	int bits = p[0];
+	int id_count = p[1];
+
+	ERR_FAIL_COND_V_MSG(bits != 1 && bits != 2 && bits != 4, false, "TerrainChannelCodec: Invalid palette bit count: " + itos(bits));
+	ERR_FAIL_COND_V_MSG(id_count == 0 || id_count > (1 << bits), false, "TerrainChannelCodec: Invalid palette size: " + itos(id_count));
+	ERR_FAIL_COND_V_MSG(ns != 2 + id_count + (size * bits + 7) / 8, false, "TerrainChannelCodec: Corrupt palette data!");
+
+	const uint8_t *ids = p + 2;
+	const uint8_t *indices = p + 2 + id_count;
+	uint8_t mask = (1 << bits) - 1;
+
+	int bit = 0;
+
+	for (int i = 0; i < size; ++i) {
+		int index = (indices[bit >> 3] >> (bit & 7)) & mask;
+
+		ERR_FAIL_COND_V_MSG(index >= id_count, false, "TerrainChannelCodec: Palette index out of range!");
+
+		r_data[i] = ids[index];
+		bit += bits;
+	}
+
+	return true;
+}
+
+bool TerrainChannelCodec::has_header(const PoolByteArray &data) {
+	return data.size() >= HEADER_SIZE && data[0] == 'T' && data[1] == 'C' && data[2] == 'C';
+}
+
+//encodes and decodes the data passes times with every filter and codec pair
+//every entry has the filter, the codec, the compressed size (header included), the ratio, and the encode / decode speed in MB/s
+Array TerrainChannelCodec::benchmark(const uint8_t *data, const int size, const int width, const int passes) {
+	Array results;
+
+	ERR_FAIL_COND_V(!data || size <= 0 || width <= 0 || passes <= 0, results);
+
+	Vector<uint8_t> decoded;
+	decoded.resize(size);
+
+	double mb = static_cast<double>(size) * passes / (1024.0 * 1024.0);
+
+	for (int filter = 0; filter < FILTER_MAX; ++filter) {
+		for (int codec = 0; codec < CODEC_MAX; ++codec) {
+			PoolByteArray encoded;
+
+			uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+			for (int i = 0; i < passes; ++i) {
+				encoded = encode(data, size, width, filter, codec);
+			}
+
+			uint64_t encode_usec = OS::get_singleton()->get_ticks_usec() - start;
+
+			ERR_CONTINUE(encoded.size() == 0);
+
+			start = OS::get_singleton()->get_ticks_usec();
+
+			for (int i = 0; i < passes; ++i) {
+				decode(encoded, decoded.ptrw(), size, width);
+			}
+
+			uint64_t decode_usec = OS::get_singleton()->get_ticks_usec() - start;
+
+			ERR_CONTINUE_MSG(memcmp(decoded.ptr(), data, size) != 0, "TerrainChannelCodec: Benchmark round trip failed!");
+
+			Dictionary d;
+			d["filter"] = filter;
+			d["codec"] = codec;
+			d["size"] = encoded.size();
+			d["ratio"] = static_cast<double>(size) / encoded.size();
+			d["encode_mbs"] = encode_usec > 0 ? mb / (encode_usec / 1000000.0) : 0.0;
+			d["decode_mbs"] = decode_usec > 0 ? mb / (decode_usec / 1000000.0) : 0.0;
+
+			results.push_back(d);
+		}
+	}
+
+	return results;
+}
+
+//goes backwards, so the neighbours are still the original values
+void TerrainChannelCodec::filter_apply(uint8_t *data, const int size, const int width, const int filter) {
+	if (filter == FILTER_DELTA) {
+		for (int i = size - 1; i > 0; --i) {
+			data[i] -= data[i - 1];
+		}
+	} else if (filter == FILTER_PREDICT_2D) {
+		for (int i = size - 1; i >= 0; --i) {
+			data[i] -= predict_2d(data, i % width, i / width, width);
+		}
+	}
+}
+//goes forward, so the neighbours are already restored
+void TerrainChannelCodec::filter_revert(uint8_t *data, const int size, const int width, const int filter) {
+	if (filter == FILTER_DELTA) {
+		for (int i = 1; i < size; ++i) {
+			data[i] += data[i - 1];
+		}
+	} else if (filter == FILTER_PREDICT_2D) {
+		for (int i = 0; i < size; ++i) {
+			data[i] += predict_2d(data, i % width, i / width, width);
+		}
+	}
+}
+
+//runs are stored as (length - 1, value) pairs
+int TerrainChannelCodec::rle_compress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size) {
+	int pos = 0;
+	int i = 0;
+
+	while (i < src_size) {
+		uint8_t v = src[i];
+		int run = 1;
+
+		while (i + run < src_size && run < 256 && src[i + run] == v) {
+			++run;
+		}
+
+		if (pos + 2 > dst_size) {
+			return -1;
+		}
+
+		dst[pos++] = run - 1;
+		dst[pos++] = v;
+
+		i += run;
+	}
+
+	return pos;
+}
+int TerrainChannelCodec::rle_decompress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size) {
+	if (src_size % 2 != 0) {
+		return -1;
+	}
+
+	int pos = 0;
+
+	for (int i = 0; i < src_size; i += 2) {
+		int run = src[i] + 1;
+
+		if (pos + run > dst_size) {
+			return -1;
+		}
+
+		memset(dst + pos, src[i + 1], run);
+		pos += run;
+	}
+
+	return pos;
+}
+
+int TerrainChannelCodec::get_max_compressed_size(const int size, const int codec) {
+	switch (codec) {
+		case CODEC_RLE:
+			return size * 2;
+		case CODEC_LZ4:
+			return LZ4_compressBound(size);
+		case CODEC_ZSTD:
+			return Compression::get_max_compressed_buffer_size(size, Compression::MODE_ZSTD);
+	}
+
+	return size;
+}
+int TerrainChannelCodec::compress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size, const int codec) {
+	switch (codec) {
+		case CODEC_RLE:
+			return rle_compress(src, src_size, dst, dst_size);
+		case CODEC_LZ4: {
+			int ns = LZ4_compress_default(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), src_size, dst_size);
+
+			return ns > 0 ? ns : -1;
+		}
+		case CODEC_ZSTD:
+			return Compression::compress(dst, src, src_size, Compression::MODE_ZSTD);
+	}
+
+	if (dst_size < src_size) {
+		return -1;
+	}
+
+	memcpy(dst, src, src_size);
+
+	return src_size;
+}
+int TerrainChannelCodec::decompress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size, const int codec) {
+	switch (codec) {
+		case CODEC_RLE:
+			return rle_decompress(src, src_size, dst, dst_size);
+		case CODEC_LZ4:
+			return LZ4_decompress_safe(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), src_size, dst_size);
+		case CODEC_ZSTD:
+			return Compression::decompress(dst, dst_size, src, src_size, Compression::MODE_ZSTD);
+	}
+
+	if (src_size > dst_size) {
+		return -1;
+	}
+
+	memcpy(dst, src, src_size);
+
+	return src_size;
+}
@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2019-2022 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef TERRAIN_CHANNEL_CODEC_H
+#define TERRAIN_CHANNEL_CODEC_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/templates/vector.h"
+#include "core/variant/variant.h"
+#else
+#include "core/variant.h"
+#include "core/vector.h"
+#endif
+
+#include "../defines.h"
+
+//Compresses channel data for saving, and sending it over the network.
+//The data gets a small header (magic, version, filter, codec, original size), so it can be validated when it's decompressed.
+//Filters run before the codec. Delta and 2d prediction turn smooth data (like isolevels and lights) into small residuals, that compress better.
+//Palette encoded channels are stored as their palette and packed indices instead (FLAG_PALETTE), they get expanded when decoded.
+class TerrainChannelCodec {
+public:
+	enum Filter {
+		FILTER_NONE = 0,
+		FILTER_DELTA,
+		FILTER_PREDICT_2D,
+		FILTER_MAX,
+	};
+
+	enum Codec {
+		CODEC_RAW = 0,
+		CODEC_RLE,
+		CODEC_LZ4,
+		CODEC_ZSTD,
+		CODEC_MAX,
+	};
+
+	enum {
+		HEADER_SIZE = 12,
+		VERSION = 1,
+	};
+
+	enum Flags {
+		FLAG_PALETTE = 1 << 0,
+	};
+
+	static PoolByteArray encode(const uint8_t *data, const int size, const int width, const int filter, const int codec);
+	static PoolByteArray encode_palette(const uint8_t *ids, const int id_count, const uint8_t *indices, const int bits, const int size, const int codec);
+	static bool decode(const PoolByteArray &data, uint8_t *r_data, const int size, const int width);
+
+	static bool has_header(const PoolByteArray &data);
+
+	static Array benchmark(const uint8_t *data, const int size, const int width, const int passes);
+
+protected:
+	static PoolByteArray compress_with_header(const uint8_t *src, const int src_size, const int original_size, const int filter, const int codec, const int flags);
+	static bool decode_palette(const uint8_t *src, const int src_size, uint8_t *r_data, const int size, const int codec);
+
+	static void filter_apply(uint8_t *data, const int size, const int width, const int filter);
+	static void filter_revert(uint8_t *data, const int size, const int width, const int filter);
+
+	static int rle_compress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size);
+	static int rle_decompress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size);
+
+	static int get_max_compressed_size(const int size, const int codec);
+	static int compress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size, const int codec);
+	static int decompress(const uint8_t *src, const int src_size, uint8_t *dst, const int dst_size, const int codec);
+
+	_FORCE_INLINE_ static uint8_t predict_2d(const uint8_t *data, const int x, const int z, const int width) {
+		if (z == 0) {
+			return x == 0 ? 0 : data[x - 1];
+		}
+
+		int up = data[(z - 1) * width + x];
+
+		if (x == 0) {
+			return up;
+		}
+
+		int left = data[z * width + x - 1];
+		int up_left = data[(z - 1) * width + x - 1];
+
+		//median edge detector, same as in jpeg-ls
+		if (up_left >= MAX(left, up)) {
+			return MIN(left, up);
+		}
+
+		if (up_left <= MIN(left, up)) {
+			return MAX(left, up);
+		}
+
+		return left + up - up_left;
+	}
+};
+
+#endif
@@ -24,23 +24,26 @@ SOFTWARE.
 
 #include "terrain_world.h"
 
-#include "../thirdparty/lz4/lz4.h"
-
 #include "../defines.h"
 
 #include "core/message_queue.h"
 #include "jobs/terrain_job.h"
+#include "terrain_channel_allocator.h"
 #include "terrain_structure.h"
 
 #if THREAD_POOL_PRESENT
 #include "../../thread_pool/thread_pool.h"
 #endif
 
+const String TerrainChunk::BINDING_STRING_STREAMING_FLAGS = "Collider,Render";
+
 _FORCE_INLINE_ bool TerrainChunk::get_process() const {
 	return _is_processing;
 }
 _FORCE_INLINE_ void TerrainChunk::set_process(const bool value) {
 	_is_processing = value;
+
+	active_sets_update();
 }
 
 _FORCE_INLINE_ bool TerrainChunk::get_physics_process() const {
@@ -48,6 +51,8 @@ _FORCE_INLINE_ bool TerrainChunk::get_physics_process() const {
 }
 _FORCE_INLINE_ void TerrainChunk::set_physics_process(const bool value) {
 	_is_phisics_processing = value;
+
+	active_sets_update();
 }
 
 bool TerrainChunk::get_visible() const {
@@ -64,6 +69,79 @@ _FORCE_INLINE_ bool TerrainChunk::get_is_generating() const {
 }
 _FORCE_INLINE_ void TerrainChunk::set_is_generating(const bool value) {
 	_is_generating = value;
+
+	active_sets_update();
+}
+
+bool TerrainChunk::get_is_generation_pending() const {
+	return _is_generation_pending;
+}
+void TerrainChunk::set_is_generation_pending(const bool value) {
+	_is_generation_pending = value;
+}
+
+//pooled chunks keep their rids when they leave the world, so they can be reused
+bool TerrainChunk::get_is_pooled() const {
+	return _is_pooled;
+}
+void TerrainChunk::set_is_pooled(const bool value) {
+	_is_pooled = value;
+}
+
+int TerrainChunk::get_streaming_flags() const {
+	return _streaming_flags;
+}
+void TerrainChunk::set_streaming_flags(const int value) {
+	if (_streaming_flags == value) {
+		return;
+	}
+
+	int old_flags = _streaming_flags;
+
+	_streaming_flags = value;
+
+	streaming_flags_changed(old_flags);
+}
+
+//colliders get built with every 2^n th data point, only used by heightmap colliders
+int TerrainChunk::get_collider_lod_level() const {
+	return _collider_lod_level;
+}
+void TerrainChunk::set_collider_lod_level(const int value) {
+	_collider_lod_level = MAX(value, 0);
+}
+
+int TerrainChunk::get_world_index() const {
+	return _world_index;
+}
+void TerrainChunk::set_world_index(const int value) {
+	_world_index = value;
+
+	active_sets_update();
+}
+
+int TerrainChunk::get_active_set_index(const int set) const {
+	ERR_FAIL_INDEX_V(set, TerrainWorld::CHUNK_ACTIVE_SET_MAX, -1);
+
+	return _active_set_indices[set];
+}
+void TerrainChunk::set_active_set_index(const int set, const int index) {
+	ERR_FAIL_INDEX(set, TerrainWorld::CHUNK_ACTIVE_SET_MAX);
+
+	_active_set_indices[set] = index;
+}
+void TerrainChunk::active_sets_update() {
+	if (!_voxel_world) {
+		return;
+	}
+
+	//jobs can finish on worker threads, the world's sets are only touched from the main thread
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		call_deferred("active_sets_update");
+		return;
+	}
+
+	_voxel_world->chunk_active_sets_update(this);
 }
 
 bool TerrainChunk::is_build_aborted() const {
@@ -236,15 +314,21 @@ TerrainWorld *TerrainChunk::get_voxel_world() const {
 	return _voxel_world;
 }
 void TerrainChunk::set_voxel_world(TerrainWorld *world) {
+	if (_voxel_world && _voxel_world != world) {
+		_voxel_world->chunk_active_sets_remove(this);
+	}
+
 	_voxel_world = world;
+
+	active_sets_update();
 }
 void TerrainChunk::set_voxel_world_bind(Node *world) {
 	if (world == NULL) {
-		_voxel_world = NULL;
+		set_voxel_world(NULL);
 		return;
 	}
 
-	_voxel_world = Object::cast_to<TerrainWorld>(world);
+	set_voxel_world(Object::cast_to<TerrainWorld>(world));
 }
 
 Ref<TerrainJob> TerrainChunk::job_get(int index) const {
@@ -259,6 +343,7 @@ void TerrainChunk::job_set(int index, const Ref<TerrainJob> &job) {
 }
 void TerrainChunk::job_remove(const int index) {
 	ERR_FAIL_INDEX(index, _jobs.size());
+	ERR_FAIL_COND_MSG(_is_generating, "TerrainChunk: Jobs can't be removed while the chunk is generating!");
 
 	_jobs.VREMOVE(index);
 }
@@ -270,52 +355,223 @@ int TerrainChunk::job_get_count() const {
 }
 
 int TerrainChunk::job_get_current_index() {
-	return _current_job;
+	_THREAD_SAFE_METHOD_
+
+	for (int i = 0; i < _job_states.size(); ++i) {
+		if (_job_states[i] == JOB_STATE_RUNNING) {
+			return i;
+		}
+	}
+
+	return -1;
 }
+//deprecated, completes the only running job
+//independent jobs can run in parallel, so jobs have to use TerrainJob::next_job() or job_complete()
 void TerrainChunk::job_next() {
-	if (_abort_build) {
-		_is_generating = false;
-		_current_job = -1;
+	_THREAD_SAFE_METHOD_
+
+	WARN_DEPRECATED_MSG("TerrainChunk::job_next() is deprecated, use TerrainJob::next_job() or TerrainChunk::job_complete() instead.");
+
+	ERR_FAIL_COND_MSG(_jobs_running > 1, "TerrainChunk::job_next(): " + itos(_jobs_running) + " jobs are running, it can't know which one finished! Use TerrainJob::next_job() or TerrainChunk::job_complete() instead.");
+
+	int index = job_get_current_index();
+
+	if (index == -1) {
 		return;
 	}
 
+	job_complete_index(index);
+}
+Ref<TerrainJob> TerrainChunk::job_get_current() {
+	_THREAD_SAFE_METHOD_
+
+	int index = job_get_current_index();
+
+	if (index == -1) {
+		return Ref<TerrainJob>();
+	}
+
+	return _jobs[index];
+}
+
+//jobs run as soon as every job they depend on completed, independent ones run in parallel
+void TerrainChunk::jobs_start() {
 	_THREAD_SAFE_METHOD_
 
-	++_current_job;
+	int count = _jobs.size();
 
-	if (_current_job >= _jobs.size()) {
-		_current_job = -1;
+	_job_states.resize(count);
+	_job_pending_dependencies.resize(count);
+	_jobs_running = 0;
+	_jobs_remaining = count;
+
+	for (int i = 0; i < count; ++i) {
+		_job_states.set(i, JOB_STATE_WAITING);
+		_job_pending_dependencies.set(i, job_index_get_dependency_count(i));
+	}
+
+	if (count == 0) {
 		set_is_generating(false);
 		finalize_build();
 		return;
 	}
 
-	Ref<TerrainJob> j = _jobs[_current_job];
+	for (int i = 0; i < count; ++i) {
+		if (_job_states[i] == JOB_STATE_WAITING && _job_pending_dependencies[i] == 0) {
+			job_start_index(i);
+		}
+	}
+}
+void TerrainChunk::job_complete(const Ref<TerrainJob> &job) {
+	_THREAD_SAFE_METHOD_
+
+	int index = _jobs.find(job);
+
+	ERR_FAIL_COND(index == -1);
+
+	job_complete_index(index);
+}
+bool TerrainChunk::job_is_running(const int index) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX_V(index, _job_states.size(), false);
+
+	return _job_states[index] == JOB_STATE_RUNNING;
+}
+int TerrainChunk::jobs_get_running_count() {
+	return _jobs_running;
+}
+
+void TerrainChunk::job_start_index(const int index) {
+	Ref<TerrainJob> j = _jobs[index];
+
+	_job_states.set(index, JOB_STATE_RUNNING);
+	++_jobs_running;
 
 	if (!j.is_valid()) {
 		//skip if invalid
-		job_next();
+		job_complete_index(index);
+		return;
 	}
 
 	j->reset();
 	j->set_complete(false);
 
 	if (j->get_build_phase_type() == TerrainJob::BUILD_PHASE_TYPE_NORMAL) {
+		job_submit(j);
+	}
+}
+void TerrainChunk::job_complete_index(const int index) {
+	ERR_FAIL_INDEX(index, _job_states.size());
+
+	if (_job_states[index] == JOB_STATE_DONE) {
+		return;
+	}
+
+	if (_job_states[index] == JOB_STATE_RUNNING) {
+		--_jobs_running;
+	}
+
+	_job_states.set(index, JOB_STATE_DONE);
+	--_jobs_remaining;
+
+	if (_abort_build) {
+		//the chunk is only done once nothing touches it anymore
+		if (_jobs_running == 0) {
+			set_is_generating(false);
+		}
+
+		return;
+	}
+
+	if (_jobs_remaining == 0) {
+		set_is_generating(false);
+		finalize_build();
+		return;
+	}
+
+	//starting a job can complete others when it runs inline, so the states are re-checked every iteration
+	for (int i = 0; i < _job_states.size(); ++i) {
+		if (_job_states[i] != JOB_STATE_WAITING || !job_index_depends_on(i, index)) {
+			continue;
+		}
+
+		int pending = _job_pending_dependencies[i] - 1;
+
+		_job_pending_dependencies.set(i, pending);
+
+		if (pending == 0) {
+			job_start_index(i);
+		}
+	}
+}
+//the thread_pool module is used when present, then the world's own worker pool, and if neither is available jobs run inline
+void TerrainChunk::job_submit(const Ref<TerrainJob> &job) {
 #if THREAD_POOL_PRESENT
-		ThreadPool::get_singleton()->add_job(j);
+	ThreadPool::get_singleton()->add_job(job);
 #else
-		j->execute();
+	if (_voxel_world && _voxel_world->worker_pool_is_running()) {
+		_voxel_world->worker_pool_add_job(job);
+		return;
+	}
+
+	job->execute();
 #endif
+}
+void TerrainChunk::job_cancel(const Ref<TerrainJob> &job) {
+	//this also stops a job that is already running inside a mesher
+	job->cancel();
+
+#if THREAD_POOL_PRESENT
+	ThreadPool::get_singleton()->cancel_job(job);
+#else
+	//jobs that got removed from the queue never run, so nothing else would complete them
+	if (_voxel_world && _voxel_world->worker_pool_is_running() && _voxel_world->worker_pool_cancel_job(job)) {
+		job->release_resources();
+
+		_THREAD_SAFE_METHOD_
+
+		int index = _jobs.find(job);
+
+		if (index != -1) {
+			job_complete_index(index);
+		}
 	}
+#endif
 }
-Ref<TerrainJob> TerrainChunk::job_get_current() {
-	_THREAD_SAFE_METHOD_
+bool TerrainChunk::job_is_queued(const Ref<TerrainJob> &job) {
+#if THREAD_POOL_PRESENT
+	return ThreadPool::get_singleton()->has_job(job);
+#else
+	return _voxel_world && _voxel_world->worker_pool_is_running() && _voxel_world->worker_pool_has_job(job);
+#endif
+}
+bool TerrainChunk::job_index_depends_on(const int index, const int dependency_index) const {
+	Ref<TerrainJob> j = _jobs[index];
 
-	if (_current_job < 0 || _current_job >= _jobs.size()) {
-		return Ref<TerrainJob>();
+	if (!j.is_valid() || j->dependency_get_count() == 0) {
+		return dependency_index == index - 1;
+	}
+
+	return j->depends_on(_jobs[dependency_index]);
+}
+int TerrainChunk::job_index_get_dependency_count(const int index) const {
+	Ref<TerrainJob> j = _jobs[index];
+
+	if (!j.is_valid() || j->dependency_get_count() == 0) {
+		return index > 0 ? 1 : 0;
+	}
+
+	//only count the ones that are actually in this chunk, so a stale dependency can't stall the build
+	int count = 0;
+
+	for (int i = 0; i < _jobs.size(); ++i) {
+		if (i != index && j->depends_on(_jobs[i])) {
+			++count;
+		}
 	}
 
-	return _jobs[_current_job];
+	return count;
 }
 
 //Terra Data
@@ -339,15 +595,13 @@ void TerrainChunk::set_size(const int size_x, const int size_z, const int margin
 	_margin_start = margin_start;
 	_margin_end = margin_end;
 
-	for (int i = 0; i < _channels.size(); ++i) {
-		uint8_t *ch = _channels[i];
-
-		if (ch != NULL) {
-			memdelete_arr(ch);
-		}
-	}
+	channel_buffers_free();
 
 	_channels.clear();
+	_channel_uniform.clear();
+	_channel_palettes.clear();
+	_channel_filters.clear();
+	_channel_codecs.clear();
 
 	channel_setup();
 }
@@ -365,8 +619,19 @@ uint8_t TerrainChunk::get_voxel(const int p_x, const int p_z, const int p_channe
 
 	uint8_t *ch = _channels.get(p_channel_index);
 
-	if (!ch)
-		return 0;
+	if (!ch) {
+		const ChannelPalette &palette = _channel_palettes[p_channel_index];
+
+		if (palette.bits != 0) {
+			int bit = get_data_index(x, z) * palette.bits;
+
+			return palette.ids[(palette.indices[bit >> 3] >> (bit & 7)) & ((1 << palette.bits) - 1)];
+		}
+
+		int uniform_value = _channel_uniform[p_channel_index];
+
+		return uniform_value != -1 ? uniform_value : 0;
+	}
 
 	return ch[get_data_index(x, z)];
 }
@@ -377,6 +642,31 @@ void TerrainChunk::set_voxel(const uint8_t p_value, const int p_x, const int p_z
 	ERR_FAIL_INDEX(p_channel_index, _channels.size());
 	ERR_FAIL_COND_MSG(!validate_data_position(x, z), "Error, index out of range! " + String::num(x) + " " + String::num(z));
 
+	if (!_channels[p_channel_index]) {
+		int uniform_value = _channel_uniform[p_channel_index];
+
+		//writing the value a uniform channel already has won't give it a buffer
+		if (uniform_value == p_value) {
+			return;
+		}
+
+		//neither does writing a new one, if the channel can use a palette
+		if (uniform_value != -1 && (_palette_channels & (1 << p_channel_index)) != 0) {
+			ChannelPalette palette;
+			palette.bits = 1;
+			palette.ids.push_back(uniform_value);
+			palette.indices.resize((get_data_size() + 7) / 8);
+			memset(palette.indices.ptrw(), 0, palette.indices.size());
+
+			_channel_palettes.set(p_channel_index, palette);
+			_channel_uniform.set(p_channel_index, -1);
+		}
+
+		if (_channel_palettes[p_channel_index].bits != 0 && channel_palette_set(p_channel_index, get_data_index(x, z), p_value)) {
+			return;
+		}
+	}
+
 	uint8_t *ch = channel_get_valid(p_channel_index);
 
 	ch[get_data_index(x, z)] = p_value;
@@ -390,19 +680,27 @@ void TerrainChunk::channel_set_count(const int count) {
 	if (count == _channels.size())
 		return;
 
-	if (_channels.size() >= count) {
-		for (int i = count; i < _channels.size(); ++i) {
-			uint8_t *ch = _channels[i];
+	int us = _channel_uniform.size();
+	_channel_uniform.resize(count);
 
-			if (ch != NULL) {
-				memdelete_arr(ch);
-			}
+	for (int i = us; i < count; ++i) {
+		_channel_uniform.set(i, -1);
+	}
 
-			_channels.set(i, NULL);
-		}
+	_channel_palettes.resize(count);
 
-		_channels.resize(count);
-		return;
+	//new channels get plain lz4, like before there were codecs
+	int cs = _channel_codecs.size();
+	_channel_filters.resize(count);
+	_channel_codecs.resize(count);
+
+	for (int i = cs; i < count; ++i) {
+		_channel_filters.set(i, CHANNEL_FILTER_NONE);
+		_channel_codecs.set(i, CHANNEL_CODEC_LZ4);
+	}
+
+	for (int i = count; i < _channels.size(); ++i) {
+		channel_buffer_release(i);
 	}
 
 	int s = _channels.size();
@@ -412,15 +710,25 @@ void TerrainChunk::channel_set_count(const int count) {
 		_channels.set(i, NULL);
 	}
 }
-bool TerrainChunk::channel_is_allocated(const int channel_index) {
+
+//bit i allows channel i to be palette encoded
+int TerrainChunk::get_palette_channels() const {
+	return _palette_channels;
+}
+void TerrainChunk::set_palette_channels(const int value) {
+	_palette_channels = value;
+}
+
+//uniform and palette encoded channels count as allocated, they just don't have a buffer yet
+bool TerrainChunk::channel_is_allocated(const int channel_index) const {
 	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
 
-	return _channels[channel_index] != NULL;
+	return _channels[channel_index] != NULL || _channel_uniform[channel_index] != -1 || _channel_palettes[channel_index].bits != 0;
 }
 void TerrainChunk::channel_ensure_allocated(const int channel_index, const uint8_t default_value) {
 	ERR_FAIL_INDEX(channel_index, _channels.size());
 
-	if (_channels[channel_index] == NULL)
+	if (!channel_is_allocated(channel_index))
 		channel_allocate(channel_index, default_value);
 }
 void TerrainChunk::channel_allocate(const int channel_index, const uint8_t default_value) {
@@ -431,42 +739,63 @@ void TerrainChunk::channel_allocate(const int channel_index, const uint8_t defau
 
 	uint32_t size = _data_size_x * _data_size_z;
 
-	uint8_t *ch = memnew_arr(uint8_t, size);
-	memset(ch, default_value, size);
+	ERR_FAIL_COND(size == 0);
 
-	_channels.set(channel_index, ch);
-}
-void TerrainChunk::channel_fill(const uint8_t value, const int channel_index) {
-	ERR_FAIL_INDEX(channel_index, _channels.size());
+	//a uniform channel keeps its value when it gets a buffer
+	uint8_t value = default_value;
 
-	uint8_t *ch = _channels.get(channel_index);
+	if (_channel_uniform[channel_index] != -1) {
+		value = _channel_uniform[channel_index];
+	}
 
-	if (ch == NULL) {
-		channel_allocate(channel_index, value);
-		return;
+	//every buffer has the same size, the one they were allocated with is kept so they can be freed even after a resize
+	if (_channel_buffer_size != size) {
+		channel_buffers_free();
+		_channel_buffer_size = size;
 	}
 
-	uint32_t size = get_data_size();
+	uint8_t *ch = TerrainChannelAllocator::alloc(size);
 
-	for (uint32_t i = 0; i < size; ++i) {
-		ch[i] = value;
+	ERR_FAIL_COND(!ch);
+
+	//so does a palette encoded one
+	if (_channel_palettes[channel_index].bits != 0) {
+		for (int z = 0; z < _data_size_z; ++z) {
+			channel_read_row(channel_index, z, ch + z * _data_size_x);
+		}
+	} else {
+		memset(ch, value, size);
 	}
+
+	_channels.set(channel_index, ch);
+	_channel_uniform.set(channel_index, -1);
+	_channel_palettes.set(channel_index, ChannelPalette());
 }
-void TerrainChunk::channel_dealloc(const int channel_index) {
+void TerrainChunk::channel_fill(const uint8_t value, const int channel_index) {
 	ERR_FAIL_INDEX(channel_index, _channels.size());
 
-	uint8_t *ch = _channels.get(channel_index);
+	channel_buffer_release(channel_index);
+
+	_channel_uniform.set(channel_index, value);
+	_channel_palettes.set(channel_index, ChannelPalette());
+}
+void TerrainChunk::channel_dealloc(const int channel_index) {
+	ERR_FAIL_INDEX(channel_index, _channels.size());
 
-	if (ch != NULL) {
-		memdelete_arr(ch);
+	_channel_uniform.set(channel_index, -1);
+	_channel_palettes.set(channel_index, ChannelPalette());
 
-		_channels.set(channel_index, NULL);
-	}
+	channel_buffer_release(channel_index);
 }
 
+//gives uniform and palette encoded channels a buffer, as the returned pointer might get written to
 uint8_t *TerrainChunk::channel_get(const int channel_index) {
 	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
 
+	if (_channels[channel_index] == NULL && channel_is_allocated(channel_index)) {
+		channel_allocate(channel_index);
+	}
+
 	return _channels.get(channel_index);
 }
 uint8_t *TerrainChunk::channel_get_valid(const int channel_index, const uint8_t default_value) {
@@ -483,112 +812,314 @@ uint8_t *TerrainChunk::channel_get_valid(const int channel_index, const uint8_t
 	return ch;
 }
 
-PoolByteArray TerrainChunk::channel_get_array(const int channel_index) const {
+//read only access, uniform channels get a shared block filled with their value instead of a buffer
+//palette encoded channels have to be read through channel_decode() or channel_read_row()
+const uint8_t *TerrainChunk::channel_get_read(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+
+	const uint8_t *ch = _channels[channel_index];
+
+	if (ch) {
+		return ch;
+	}
+
+	ERR_FAIL_COND_V_MSG(_channel_palettes[channel_index].bits != 0, NULL, "TerrainChunk: Palette encoded channels need to be read using channel_decode()!");
+
+	int uniform_value = _channel_uniform[channel_index];
+
+	if (uniform_value == -1) {
+		return NULL;
+	}
+
+	return TerrainChannelAllocator::get_uniform_block(uniform_value, get_data_size());
+}
+const uint8_t *TerrainChunk::channel_get_read_valid(const int channel_index, const uint8_t default_value) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+
+	const uint8_t *ch = channel_get_read(channel_index);
+
+	if (ch) {
+		return ch;
+	}
+
+	return TerrainChannelAllocator::get_uniform_block(default_value, get_data_size());
+}
+
+bool TerrainChunk::channel_is_uniform(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	return _channel_uniform[channel_index] != -1;
+}
+int TerrainChunk::channel_get_uniform_value(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), -1);
+
+	return _channel_uniform[channel_index];
+}
+
+//turns the channel back into a uniform one, if every value in it is the same,
+//or into a palette encoded one if it's allowed to, and it only has a few different values
+//palette encoded channels drop the ids that got overwritten since they were encoded
+void TerrainChunk::channel_compact(const int channel_index) {
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	const uint8_t *ch = _channels[channel_index];
+
+	if (!ch) {
+		if (_channel_palettes[channel_index].bits != 0) {
+			channel_palette_trim(channel_index);
+		}
+
+		return;
+	}
+
+	uint32_t size = get_data_size();
+	uint8_t value = ch[0];
+
+	for (uint32_t i = 1; i < size; ++i) {
+		if (ch[i] != value) {
+			if ((_palette_channels & (1 << channel_index)) != 0) {
+				channel_palette_encode(channel_index);
+			}
+
+			return;
+		}
+	}
+
+	channel_fill(value, channel_index);
+}
+void TerrainChunk::channels_compact() {
+	for (int i = 0; i < _channels.size(); ++i) {
+		channel_compact(i);
+	}
+}
+
+bool TerrainChunk::channel_is_palette_encoded(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	return _channel_palettes[channel_index].bits != 0;
+}
+
+//the ids a uniform or palette encoded channel contains, empty for every other channel
+PoolByteArray TerrainChunk::channel_get_palette(const int channel_index) const {
 	PoolByteArray arr;
 
-	uint32_t size = _data_size_x * _data_size_z;
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), arr);
 
-	if (channel_index >= _channels.size())
+	if (_channel_uniform[channel_index] != -1) {
+		arr.push_back(_channel_uniform[channel_index]);
 		return arr;
+	}
 
-	uint8_t *ch = _channels.get(channel_index);
+	const ChannelPalette &palette = _channel_palettes[channel_index];
 
-	if (ch == NULL)
+	if (palette.bits == 0) {
 		return arr;
+	}
 
-	arr.resize(size);
+	//palettes only grow between compactions, so only the ids that are still in use get returned
+	bool used[16];
+	channel_palette_get_used(channel_index, used);
 
-	for (uint32_t i = 0; i < size; ++i) {
-		arr.set(i, ch[i]);
+	for (int i = 0; i < palette.ids.size(); ++i) {
+		if (used[i]) {
+			arr.push_back(palette.ids[i]);
+		}
 	}
 
 	return arr;
 }
-void TerrainChunk::channel_set_array(const int channel_index, const PoolByteArray &array) {
-	if (array.size() == 0)
+
+//decodes one row (data_size_x values) of the channel, whatever way it's stored
+void TerrainChunk::channel_read_row(const int channel_index, const int z, uint8_t *r_row) const {
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+	ERR_FAIL_INDEX(z, _data_size_z);
+
+	const uint8_t *ch = _channels[channel_index];
+
+	if (ch) {
+		memcpy(r_row, ch + z * _data_size_x, _data_size_x);
 		return;
+	}
 
-	if (_channels.size() <= channel_index)
-		channel_set_count(channel_index + 1);
+	const ChannelPalette &palette = _channel_palettes[channel_index];
 
-	uint8_t *ch = _channels.get(channel_index);
+	if (palette.bits == 0) {
+		int uniform_value = _channel_uniform[channel_index];
 
-	if (ch == NULL) {
-		if (_channels[channel_index] != NULL)
-			return;
+		memset(r_row, uniform_value != -1 ? uniform_value : 0, _data_size_x);
+		return;
+	}
+
+	const uint8_t *ids = palette.ids.ptr();
+	const uint8_t *indices = palette.indices.ptr();
+	int bits = palette.bits;
+	uint8_t mask = (1 << bits) - 1;
 
-		ch = memnew_arr(uint8_t, array.size());
-		_channels.set(channel_index, ch);
+	int bit = z * _data_size_x * bits;
+
+	for (int x = 0; x < _data_size_x; ++x) {
+		r_row[x] = ids[(indices[bit >> 3] >> (bit & 7)) & mask];
+		bit += bits;
+	}
+}
+
+//same as channel_get_read(), but palette encoded channels get decoded into r_storage
+const uint8_t *TerrainChunk::channel_decode(const int channel_index, Vector<uint8_t> &r_storage) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+
+	if (_channel_palettes[channel_index].bits == 0) {
+		return channel_get_read(channel_index);
 	}
 
-	for (int i = 0; i < array.size(); ++i) {
-		ch[i] = array[i];
+	r_storage.resize(get_data_size());
+	uint8_t *w = r_storage.ptrw();
+
+	for (int z = 0; z < _data_size_z; ++z) {
+		channel_read_row(channel_index, z, w + z * _data_size_x);
 	}
+
+	return r_storage.ptr();
 }
 
-PoolByteArray TerrainChunk::channel_get_compressed(const int channel_index) const {
+//both directions copy the whole channel at once, through one lock on the array
+PoolByteArray TerrainChunk::channel_get_array(const int channel_index) const {
 	PoolByteArray arr;
 
-	int size = _data_size_x * _data_size_z;
-
 	if (channel_index >= _channels.size())
 		return arr;
 
-	uint8_t *ch = _channels.get(channel_index);
-
-	if (ch == NULL)
+	if (!channel_is_allocated(channel_index))
 		return arr;
 
-	int bound = LZ4_compressBound(size);
-	arr.resize(bound);
+	arr.resize(get_data_size());
 
+	//uniform and palette encoded channels get decoded right into the array
 #if !GODOT4
 	PoolByteArray::Write w = arr.write();
+	uint8_t *data = w.ptr();
+#else
+	uint8_t *data = arr.ptrw();
+#endif
 
-	int ns = LZ4_compress_default(reinterpret_cast<char *>(ch), reinterpret_cast<char *>(w.ptr()), size, bound);
+	for (int z = 0; z < _data_size_z; ++z) {
+		channel_read_row(channel_index, z, data + z * _data_size_x);
+	}
 
+#if !GODOT4
 	w.release();
-#else
-	int ns = LZ4_compress_default(reinterpret_cast<char *>(ch), reinterpret_cast<char *>(arr.ptrw()), size, bound);
 #endif
-	arr.resize(ns);
 
 	return arr;
 }
+void TerrainChunk::channel_set_array(const int channel_index, const PoolByteArray &array) {
+	if (array.size() == 0)
+		return;
+
+	if (_channels.size() <= channel_index)
+		channel_set_count(channel_index + 1);
+
+	int size = MIN(array.size(), get_data_size());
+
+	//a full array replaces uniform and palette data, there is no need to decode them first
+	if (size == get_data_size() && !_channels[channel_index]) {
+		channel_dealloc(channel_index);
+	}
+
+	uint8_t *ch = channel_get_valid(channel_index);
+
+	ERR_FAIL_COND(!ch);
+
+#if !GODOT4
+	PoolByteArray::Read r = array.read();
+
+	memcpy(ch, r.ptr(), size);
+#else
+	memcpy(ch, array.ptr(), size);
+#endif
+}
+
+//the compressed data starts with a TerrainChannelCodec header, so it can be validated when it's loaded
+PoolByteArray TerrainChunk::channel_get_compressed(const int channel_index) const {
+	PoolByteArray arr;
+
+	if (channel_index >= _channels.size())
+		return arr;
+
+	//palette encoded channels are stored as they are, they get expanded when they are loaded
+	const ChannelPalette &palette = _channel_palettes[channel_index];
+
+	if (palette.bits != 0) {
+		return TerrainChannelCodec::encode_palette(palette.ids.ptr(), palette.ids.size(), palette.indices.ptr(), palette.bits, get_data_size(), _channel_codecs[channel_index]);
+	}
+
+	Vector<uint8_t> decoded;
+	const uint8_t *ch = channel_decode(channel_index, decoded);
+
+	if (ch == NULL)
+		return arr;
+
+	return TerrainChannelCodec::encode(ch, get_data_size(), _data_size_x, _channel_filters[channel_index], _channel_codecs[channel_index]);
+}
 void TerrainChunk::channel_set_compressed(const int channel_index, const PoolByteArray &data) {
 	if (data.size() == 0)
 		return;
 
-	int size = _data_size_x * _data_size_z;
+	int size = get_data_size();
+
+	ERR_FAIL_COND(size == 0);
 
 	if (_channels.size() <= channel_index)
 		channel_set_count(channel_index + 1);
 
-	uint8_t *ch = _channels.get(channel_index);
+	//decoded into a temporary first, so broken data doesn't overwrite the channel
+	Vector<uint8_t> decoded;
+	decoded.resize(size);
+
+	if (!TerrainChannelCodec::decode(data, decoded.ptrw(), size, _data_size_x)) {
+		return;
+	}
+
+	if (!_channels[channel_index]) {
+		channel_dealloc(channel_index);
+	}
+
+	uint8_t *ch = channel_get_valid(channel_index);
+
+	ERR_FAIL_COND(!ch);
+
+	memcpy(ch, decoded.ptr(), size);
 
-	if (ch == NULL) {
-		if (_channels[channel_index] != NULL)
-			return;
+	channel_compact(channel_index);
+}
 
-		ch = memnew_arr(uint8_t, size);
-		_channels.set(channel_index, ch);
-	}
+int TerrainChunk::channel_get_compression_filter(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), CHANNEL_FILTER_NONE);
 
-	int ds = data.size();
+	return _channel_filters[channel_index];
+}
+int TerrainChunk::channel_get_compression_codec(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), CHANNEL_CODEC_LZ4);
 
-#if !GODOT4
-	PoolByteArray::Read r = data.read();
+	return _channel_codecs[channel_index];
+}
+void TerrainChunk::channel_set_compression(const int channel_index, const int filter, const int codec) {
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+	ERR_FAIL_INDEX(filter, TerrainChannelCodec::FILTER_MAX);
+	ERR_FAIL_INDEX(codec, TerrainChannelCodec::CODEC_MAX);
 
-	//We are not going to write to it
-	uint8_t *data_arr = const_cast<uint8_t *>(r.ptr());
+	_channel_filters.set(channel_index, filter);
+	_channel_codecs.set(channel_index, codec);
+}
+//runs TerrainChannelCodec::benchmark() on the channel's current data, to help picking its compression setup
+Array TerrainChunk::channel_benchmark_compression(const int channel_index, const int passes) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), Array());
 
-	LZ4_decompress_safe(reinterpret_cast<char *>(data_arr), reinterpret_cast<char *>(ch), ds, size);
-#else
-	//We are not going to write to it
-	uint8_t *data_arr = const_cast<uint8_t *>(data.ptr());
+	Vector<uint8_t> decoded;
+	const uint8_t *ch = channel_decode(channel_index, decoded);
 
-	LZ4_decompress_safe(reinterpret_cast<char *>(data_arr), reinterpret_cast<char *>(ch), ds, size);
-#endif
+	ERR_FAIL_COND_V_MSG(!ch, Array(), "TerrainChunk: The channel is not allocated!");
+
+	return TerrainChannelCodec::benchmark(ch, get_data_size(), _data_size_x, passes);
 }
 
 _FORCE_INLINE_ int TerrainChunk::get_index(const int x, const int z) const {
@@ -603,6 +1134,44 @@ _FORCE_INLINE_ int TerrainChunk::get_data_size() const {
 	return _data_size_x * _data_size_z;
 }
 
+//fnv-1a
+uint64_t TerrainChunk::hash_buffer(const uint8_t *data, const int size, const uint64_t hash) {
+	uint64_t h = hash;
+
+	for (int i = 0; i < size; ++i) {
+		h ^= data[i];
+		h *= 1099511628211ULL;
+	}
+
+	return h;
+}
+
+//covers the layout and every channel, so it changes whenever the meshes could
+uint64_t TerrainChunk::get_data_hash() const {
+	int header[3] = { _data_size_x, _data_size_z, _channels.size() };
+
+	uint64_t h = hash_buffer(reinterpret_cast<const uint8_t *>(header), sizeof(header));
+
+	int size = get_data_size();
+
+	Vector<uint8_t> decoded;
+
+	//uniform and palette encoded channels hash the same as a buffer with the same values
+	for (int i = 0; i < _channels.size(); ++i) {
+		const uint8_t *ch = channel_decode(i, decoded);
+
+		if (ch == NULL) {
+			uint8_t empty = 0xFF;
+			h = hash_buffer(&empty, 1, h);
+			continue;
+		}
+
+		h = hash_buffer(ch, size, h);
+	}
+
+	return h;
+}
+
 //Terra Structures
 
 Ref<TerrainStructure> TerrainChunk::voxel_structure_get(const int index) const {
@@ -670,9 +1239,9 @@ void TerrainChunk::_build() {
 		return;
 	}
 
-	_is_generating = true;
+	set_is_generating(true);
 
-	job_next();
+	jobs_start();
 }
 
 void TerrainChunk::clear() {
@@ -692,15 +1261,21 @@ void TerrainChunk::cancel_build() {
 
 	_abort_build = true;
 
-#if THREAD_POOL_PRESENT
 	if (_is_generating) {
-		Ref<TerrainJob> job = job_get_current();
+		_THREAD_SAFE_METHOD_
+
+		for (int i = 0; i < _job_states.size(); ++i) {
+			if (_job_states[i] != JOB_STATE_RUNNING) {
+				continue;
+			}
+
+			Ref<TerrainJob> job = _jobs[i];
 
-		if (job.is_valid()) {
-			ThreadPool::get_singleton()->cancel_job(job);
+			if (job.is_valid()) {
+				job_cancel(job);
+			}
 		}
 	}
-#endif
 }
 
 void TerrainChunk::bake_lights() {
@@ -996,6 +1571,10 @@ void TerrainChunk::exit_tree() {
 	if (has_method("_exit_tree"))
 		call("_exit_tree");
 }
+//resets the chunk so the world can use it for new coordinates, allocations are kept
+void TerrainChunk::recycle() {
+	call("_recycle");
+}
 void TerrainChunk::process(const float delta) {
 	if (has_method("_process"))
 		call("_process", delta);
@@ -1011,6 +1590,10 @@ void TerrainChunk::visibility_changed(const bool visible) {
 	if (has_method("_visibility_changed"))
 		call("_visibility_changed", _is_visible);
 }
+void TerrainChunk::streaming_flags_changed(const int old_flags) {
+	if (has_method("_streaming_flags_changed"))
+		call("_streaming_flags_changed", old_flags);
+}
 void TerrainChunk::world_light_added(const Ref<TerrainLight> &light) {
 	if (has_method("_world_light_added"))
 		call("_world_light_added", light);
@@ -1048,21 +1631,25 @@ Vector3 TerrainChunk::to_global(Vector3 p_local) const {
 }
 
 bool TerrainChunk::is_safe_to_delete() {
-#if THREAD_POOL_PRESENT
 	if (!_is_generating) {
 		return true;
 	}
 
-	Ref<TerrainJob> job = job_get_current();
+	_THREAD_SAFE_METHOD_
+
+	for (int i = 0; i < _job_states.size(); ++i) {
+		if (_job_states[i] != JOB_STATE_RUNNING) {
+			continue;
+		}
+
+		Ref<TerrainJob> job = _jobs[i];
 
-	if (!job.is_valid()) {
-		return true;
+		if (job.is_valid() && job_is_queued(job)) {
+			return false;
+		}
 	}
 
-	return !ThreadPool::get_singleton()->has_job(job);
-#else
 	return true;
-#endif
 }
 
 TerrainChunk::TerrainChunk() {
@@ -1073,6 +1660,16 @@ TerrainChunk::TerrainChunk() {
 	_is_visible = true;
 
 	_is_generating = false;
+	_is_generation_pending = false;
+	_is_pooled = false;
+	_streaming_flags = STREAMING_FLAGS_ALL;
+	_collider_lod_level = 0;
+	_world_index = -1;
+
+	for (int i = 0; i < TerrainWorld::CHUNK_ACTIVE_SET_MAX; ++i) {
+		_active_set_indices[i] = -1;
+	}
+
 	_dirty = false;
 	_state = TERRAIN_CHUNK_STATE_OK;
 
@@ -1101,14 +1698,27 @@ TerrainChunk::TerrainChunk() {
 	_prop_material_cache_key = 0;
 	_prop_material_cache_key_has = false;
 
-	_current_job = -1;
+	_jobs_running = 0;
+	_jobs_remaining = 0;
 
 	_world_height = 256;
 
+	_channel_buffer_size = 0;
+
+	_palette_channels = 0;
+
 	_queued_generation = false;
 }
 
 TerrainChunk::~TerrainChunk() {
+	//the world clears every index when it goes away, so it's still alive if any of these are set
+	for (int i = 0; i < TerrainWorld::CHUNK_ACTIVE_SET_MAX; ++i) {
+		if (_active_set_indices[i] != -1 && _voxel_world) {
+			_voxel_world->chunk_active_sets_remove(this);
+			break;
+		}
+	}
+
 	if (_library.is_valid()) {
 		_library.unref();
 	}
@@ -1121,13 +1731,7 @@ TerrainChunk::~TerrainChunk() {
 	mesh_data_resource_clear();
 #endif
 
-	for (int i = 0; i < _channels.size(); ++i) {
-		uint8_t *ch = _channels[i];
-
-		if (ch != NULL) {
-			memdelete_arr(ch);
-		}
-	}
+	channel_buffers_free();
 
 	for (int i = 0; i < _colliders.size(); ++i) {
 		PhysicsServer::get_singleton()->free(_colliders[i].body);
@@ -1168,6 +1772,77 @@ void TerrainChunk::_exit_tree() {
 	}
 }
 
+void TerrainChunk::_recycle() {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_MSG(_is_in_tree, "TerrainChunk: Only chunks that left the world can be recycled!");
+
+	_abort_build = false;
+	_queued_generation = false;
+	_is_generation_pending = false;
+	_dirty = false;
+	_state = TERRAIN_CHUNK_STATE_OK;
+	_streaming_flags = STREAMING_FLAGS_ALL;
+	_collider_lod_level = 0;
+
+	set_is_generating(false);
+
+	_job_states.clear();
+	_job_pending_dependencies.clear();
+	_jobs_running = 0;
+	_jobs_remaining = 0;
+
+	for (int i = 0; i < _jobs.size(); ++i) {
+		Ref<TerrainJob> j = _jobs[i];
+
+		if (j.is_valid()) {
+			j->chunk_recycled();
+		}
+	}
+
+	//the material cache was already released in _exit_tree
+	if (_library.is_valid() && _library->supports_caching()) {
+		if (liquid_material_cache_key_has()) {
+			_library->liquid_material_cache_unref(liquid_material_cache_key_get());
+		}
+
+		if (prop_material_cache_key_has()) {
+			_library->prop_material_cache_unref(prop_material_cache_key_get());
+		}
+	}
+
+	_material_cache_key_has = false;
+	_liquid_material_cache_key_has = false;
+	_prop_material_cache_key_has = false;
+
+	//allocated channels go back to zero without a buffer, so pooled chunks don't hold on to memory
+	for (int i = 0; i < _channels.size(); ++i) {
+		if (channel_is_allocated(i)) {
+			_channel_uniform.set(i, 0);
+		}
+
+		_channel_palettes.set(i, ChannelPalette());
+	}
+
+	channel_buffers_free();
+
+	_voxel_structures.clear();
+
+#if PROPS_PRESENT
+	props_clear();
+#endif
+
+#if MESH_DATA_RESOURCE_PRESENT
+	mesh_data_resource_clear();
+#endif
+
+	for (int i = 0; i < _colliders.size(); ++i) {
+		PhysicsServer::get_singleton()->free(_colliders[i].body);
+	}
+
+	_colliders.clear();
+}
+
 void TerrainChunk::_generation_process(const float delta) {
 	if (_abort_build) {
 		return;
@@ -1175,25 +1850,37 @@ void TerrainChunk::_generation_process(const float delta) {
 
 	_THREAD_SAFE_METHOD_
 
-	if (_current_job < 0 || _current_job >= _jobs.size())
-		return;
+	//more than one job can be running at the same time
+	for (int i = 0; i < _job_states.size(); ++i) {
+		if (_abort_build) {
+			return;
+		}
 
-	Ref<TerrainJob> job = _jobs[_current_job];
+		if (_job_states[i] != JOB_STATE_RUNNING) {
+			continue;
+		}
 
-	ERR_FAIL_COND(!job.is_valid());
+		Ref<TerrainJob> job = _jobs[i];
 
-	if (job->get_build_phase_type() == TerrainJob::BUILD_PHASE_TYPE_PROCESS) {
-		if (!_voxel_world->can_chunk_do_build_step())
-			return;
+		ERR_CONTINUE(!job.is_valid());
+
+		if (job->get_build_phase_type() != TerrainJob::BUILD_PHASE_TYPE_PROCESS) {
+			continue;
+		}
+
+		int step = job->get_build_step_id();
+
+		if (!_voxel_world->build_step_begin(step, false))
+			continue;
+
+		uint64_t start = OS::get_singleton()->get_ticks_usec();
 
 		job->process(delta);
 
+		_voxel_world->build_step_end(step, false, static_cast<int>(OS::get_singleton()->get_ticks_usec() - start));
+
 		if (job->get_build_phase_type() == TerrainJob::BUILD_PHASE_TYPE_NORMAL) {
-#if THREAD_POOL_PRESENT
-			ThreadPool::get_singleton()->add_job(job);
-#else
-			job->execute();
-#endif
+			job_submit(job);
 		}
 	}
 }
@@ -1204,27 +1891,257 @@ void TerrainChunk::_generation_physics_process(const float delta) {
 
 	_THREAD_SAFE_METHOD_
 
-	if (_current_job < 0 || _current_job >= _jobs.size())
-		return;
+	//more than one job can be running at the same time
+	for (int i = 0; i < _job_states.size(); ++i) {
+		if (_abort_build) {
+			return;
+		}
 
-	Ref<TerrainJob> job = _jobs[_current_job];
+		if (_job_states[i] != JOB_STATE_RUNNING) {
+			continue;
+		}
 
-	ERR_FAIL_COND(!job.is_valid());
+		Ref<TerrainJob> job = _jobs[i];
 
-	if (job->get_build_phase_type() == TerrainJob::BUILD_PHASE_TYPE_PHYSICS_PROCESS) {
-		if (!_voxel_world->can_chunk_do_build_step())
-			return;
+		ERR_CONTINUE(!job.is_valid());
+
+		if (job->get_build_phase_type() != TerrainJob::BUILD_PHASE_TYPE_PHYSICS_PROCESS) {
+			continue;
+		}
+
+		int step = job->get_build_step_id();
+
+		if (!_voxel_world->build_step_begin(step, true))
+			continue;
+
+		uint64_t start = OS::get_singleton()->get_ticks_usec();
 
 		job->physics_process(delta);
 
+		_voxel_world->build_step_end(step, true, static_cast<int>(OS::get_singleton()->get_ticks_usec() - start));
+
 		if (job->get_build_phase_type() == TerrainJob::BUILD_PHASE_TYPE_NORMAL) {
-#if THREAD_POOL_PRESENT
-			ThreadPool::get_singleton()->add_job(job);
-#else
-			job->execute();
-#endif
+			job_submit(job);
+		}
+	}
+}
+
+//gives the buffer of the channel back to the allocator
+void TerrainChunk::channel_buffer_release(const int channel_index) {
+	uint8_t *ch = _channels[channel_index];
+
+	if (ch == NULL) {
+		return;
+	}
+
+	_channels.set(channel_index, NULL);
+
+	TerrainChannelAllocator::free(ch, _channel_buffer_size);
+}
+int TerrainChunk::get_palette_bits(const int id_count) {
+	if (id_count <= 2) {
+		return 1;
+	}
+
+	if (id_count <= 4) {
+		return 2;
+	}
+
+	if (id_count <= 16) {
+		return 4;
+	}
+
+	return 0;
+}
+void TerrainChunk::channel_palette_encode(const int channel_index) {
+	const uint8_t *ch = _channels[channel_index];
+
+	if (!ch) {
+		return;
+	}
+
+	uint32_t size = get_data_size();
+
+	int lookup[256];
+
+	for (int i = 0; i < 256; ++i) {
+		lookup[i] = -1;
+	}
+
+	ChannelPalette palette;
+
+	for (uint32_t i = 0; i < size; ++i) {
+		uint8_t v = ch[i];
+
+		if (lookup[v] != -1) {
+			continue;
+		}
+
+		if (palette.ids.size() == 16) {
+			return;
+		}
+
+		lookup[v] = palette.ids.size();
+		palette.ids.push_back(v);
+	}
+
+	palette.bits = get_palette_bits(palette.ids.size());
+	palette.indices.resize((size * palette.bits + 7) / 8);
+
+	uint8_t *w = palette.indices.ptrw();
+	memset(w, 0, palette.indices.size());
+
+	int bit = 0;
+
+	for (uint32_t i = 0; i < size; ++i) {
+		w[bit >> 3] |= lookup[ch[i]] << (bit & 7);
+		bit += palette.bits;
+	}
+
+	channel_buffer_release(channel_index);
+
+	_channel_palettes.set(channel_index, palette);
+}
+void TerrainChunk::channel_palette_repack(ChannelPalette &palette, const int bits) {
+	uint32_t size = get_data_size();
+
+	Vector<uint8_t> indices;
+	indices.resize((size * bits + 7) / 8);
+
+	uint8_t *w = indices.ptrw();
+	memset(w, 0, indices.size());
+
+	const uint8_t *r = palette.indices.ptr();
+	uint8_t mask = (1 << palette.bits) - 1;
+
+	for (uint32_t i = 0; i < size; ++i) {
+		int old_bit = i * palette.bits;
+		int new_bit = i * bits;
+
+		w[new_bit >> 3] |= ((r[old_bit >> 3] >> (old_bit & 7)) & mask) << (new_bit & 7);
+	}
+
+	palette.indices = indices;
+	palette.bits = bits;
+}
+void TerrainChunk::channel_palette_get_used(const int channel_index, bool *r_used) const {
+	const ChannelPalette &palette = _channel_palettes[channel_index];
+
+	for (int i = 0; i < 16; ++i) {
+		r_used[i] = false;
+	}
+
+	uint32_t size = get_data_size();
+	const uint8_t *r = palette.indices.ptr();
+	uint8_t mask = (1 << palette.bits) - 1;
+
+	int bit = 0;
+
+	for (uint32_t i = 0; i < size; ++i) {
+		r_used[(r[bit >> 3] >> (bit & 7)) & mask] = true;
+		bit += palette.bits;
+	}
+}
+//rebuilds the palette without the ids that aren't used anymore
+void TerrainChunk::channel_palette_trim(const int channel_index) {
+	const ChannelPalette &palette = _channel_palettes[channel_index];
+
+	bool used[16];
+	channel_palette_get_used(channel_index, used);
+
+	int remap[16];
+	Vector<uint8_t> ids;
+
+	for (int i = 0; i < palette.ids.size(); ++i) {
+		if (used[i]) {
+			remap[i] = ids.size();
+			ids.push_back(palette.ids[i]);
+		} else {
+			remap[i] = -1;
+		}
+	}
+
+	if (ids.size() == palette.ids.size()) {
+		return;
+	}
+
+	if (ids.size() == 1) {
+		channel_fill(ids[0], channel_index);
+		return;
+	}
+
+	uint32_t size = get_data_size();
+
+	ChannelPalette trimmed;
+	trimmed.ids = ids;
+	trimmed.bits = get_palette_bits(ids.size());
+	trimmed.indices.resize((size * trimmed.bits + 7) / 8);
+
+	uint8_t *w = trimmed.indices.ptrw();
+	memset(w, 0, trimmed.indices.size());
+
+	const uint8_t *r = palette.indices.ptr();
+	uint8_t mask = (1 << palette.bits) - 1;
+
+	for (uint32_t i = 0; i < size; ++i) {
+		int old_bit = i * palette.bits;
+		int new_bit = i * trimmed.bits;
+
+		w[new_bit >> 3] |= remap[(r[old_bit >> 3] >> (old_bit & 7)) & mask] << (new_bit & 7);
+	}
+
+	_channel_palettes.set(channel_index, trimmed);
+}
+//returns false if the palette can't take a new id, in that case the channel needs a buffer
+bool TerrainChunk::channel_palette_set(const int channel_index, const int data_index, const uint8_t value) {
+	ChannelPalette &palette = _channel_palettes.write[channel_index];
+
+	int index = palette.ids.find(value);
+
+	if (index == -1) {
+		int bits = get_palette_bits(palette.ids.size() + 1);
+
+		if (bits == 0) {
+			return false;
 		}
+
+		if (bits != palette.bits) {
+			channel_palette_repack(palette, bits);
+		}
+
+		index = palette.ids.size();
+		palette.ids.push_back(value);
+	}
+
+	int bit = data_index * palette.bits;
+	uint8_t mask = ((1 << palette.bits) - 1) << (bit & 7);
+
+	uint8_t *w = palette.indices.ptrw();
+	w[bit >> 3] = (w[bit >> 3] & ~mask) | ((index << (bit & 7)) & mask);
+
+	return true;
+}
+void TerrainChunk::channel_buffers_free() {
+	for (int i = 0; i < _channels.size(); ++i) {
+		channel_buffer_release(i);
+	}
+}
+
+//what the channels take up right now, only channels that have a buffer or a palette count
+int TerrainChunk::get_channel_memory_usage() const {
+	int usage = 0;
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		if (_channels[i] != NULL) {
+			usage += TerrainChannelAllocator::get_block_size(_channel_buffer_size);
+		}
+
+		const ChannelPalette &palette = _channel_palettes[i];
+
+		usage += palette.ids.size() + palette.indices.size();
 	}
+
+	return usage;
 }
 
 void TerrainChunk::_world_transform_changed() {
@@ -1303,6 +2220,7 @@ void TerrainChunk::_bind_methods() {
 	//BIND_VMETHOD(MethodInfo("_physics_process", PropertyInfo(Variant::REAL, "delta")));
 	//BIND_VMETHOD(MethodInfo("_world_transform_changed"));
 	//BIND_VMETHOD(MethodInfo("_visibility_changed", PropertyInfo(Variant::BOOL, "visible")));
+	//BIND_VMETHOD(MethodInfo("_streaming_flags_changed", PropertyInfo(Variant::INT, "old_flags")));
 	//BIND_VMETHOD(MethodInfo("_world_light_added", PropertyInfo(Variant::OBJECT, "light", PROPERTY_HINT_RESOURCE_TYPE, "TerrainLight")));
 	//BIND_VMETHOD(MethodInfo("_world_light_removed", PropertyInfo(Variant::OBJECT, "light", PROPERTY_HINT_RESOURCE_TYPE, "TerrainLight")));
 
@@ -1313,10 +2231,12 @@ void TerrainChunk::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("enter_tree"), &TerrainChunk::enter_tree);
 	ClassDB::bind_method(D_METHOD("exit_tree"), &TerrainChunk::exit_tree);
+	ClassDB::bind_method(D_METHOD("recycle"), &TerrainChunk::recycle);
 	ClassDB::bind_method(D_METHOD("process", "delta"), &TerrainChunk::process);
 	ClassDB::bind_method(D_METHOD("physics_process", "delta"), &TerrainChunk::physics_process);
 	ClassDB::bind_method(D_METHOD("world_transform_changed"), &TerrainChunk::world_transform_changed);
 	ClassDB::bind_method(D_METHOD("visibility_changed", "visible"), &TerrainChunk::visibility_changed);
+	ClassDB::bind_method(D_METHOD("streaming_flags_changed", "old_flags"), &TerrainChunk::streaming_flags_changed);
 	ClassDB::bind_method(D_METHOD("world_light_added", "light"), &TerrainChunk::world_light_added);
 	ClassDB::bind_method(D_METHOD("world_light_removed", "light"), &TerrainChunk::world_light_removed);
 
@@ -1347,6 +2267,29 @@ void TerrainChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_is_generating", "value"), &TerrainChunk::set_is_generating);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "is_generating", PROPERTY_HINT_NONE, "", 0), "set_is_generating", "get_is_generating");
 
+	ClassDB::bind_method(D_METHOD("get_is_generation_pending"), &TerrainChunk::get_is_generation_pending);
+	ClassDB::bind_method(D_METHOD("set_is_generation_pending", "value"), &TerrainChunk::set_is_generation_pending);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "is_generation_pending", PROPERTY_HINT_NONE, "", 0), "set_is_generation_pending", "get_is_generation_pending");
+
+	ClassDB::bind_method(D_METHOD("get_is_pooled"), &TerrainChunk::get_is_pooled);
+	ClassDB::bind_method(D_METHOD("set_is_pooled", "value"), &TerrainChunk::set_is_pooled);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "is_pooled", PROPERTY_HINT_NONE, "", 0), "set_is_pooled", "get_is_pooled");
+
+	ClassDB::bind_method(D_METHOD("get_streaming_flags"), &TerrainChunk::get_streaming_flags);
+	ClassDB::bind_method(D_METHOD("set_streaming_flags", "value"), &TerrainChunk::set_streaming_flags);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "streaming_flags", PROPERTY_HINT_FLAGS, BINDING_STRING_STREAMING_FLAGS, 0), "set_streaming_flags", "get_streaming_flags");
+
+	ClassDB::bind_method(D_METHOD("get_collider_lod_level"), &TerrainChunk::get_collider_lod_level);
+	ClassDB::bind_method(D_METHOD("set_collider_lod_level", "value"), &TerrainChunk::set_collider_lod_level);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "collider_lod_level", PROPERTY_HINT_NONE, "", 0), "set_collider_lod_level", "get_collider_lod_level");
+
+	ClassDB::bind_method(D_METHOD("get_world_index"), &TerrainChunk::get_world_index);
+	ClassDB::bind_method(D_METHOD("set_world_index", "value"), &TerrainChunk::set_world_index);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "world_index", PROPERTY_HINT_NONE, "", 0), "set_world_index", "get_world_index");
+
+	ClassDB::bind_method(D_METHOD("get_active_set_index", "set"), &TerrainChunk::get_active_set_index);
+	ClassDB::bind_method(D_METHOD("active_sets_update"), &TerrainChunk::active_sets_update);
+
 	ClassDB::bind_method(D_METHOD("is_build_aborted"), &TerrainChunk::is_build_aborted);
 
 	ClassDB::bind_method(D_METHOD("get_dirty"), &TerrainChunk::get_dirty);
@@ -1441,6 +2384,10 @@ void TerrainChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("job_get_current_index"), &TerrainChunk::job_get_current_index);
 	ClassDB::bind_method(D_METHOD("job_next"), &TerrainChunk::job_next);
 	ClassDB::bind_method(D_METHOD("job_get_current"), &TerrainChunk::job_get_current);
+	ClassDB::bind_method(D_METHOD("jobs_start"), &TerrainChunk::jobs_start);
+	ClassDB::bind_method(D_METHOD("job_complete", "job"), &TerrainChunk::job_complete);
+	ClassDB::bind_method(D_METHOD("job_is_running", "index"), &TerrainChunk::job_is_running);
+	ClassDB::bind_method(D_METHOD("jobs_get_running_count"), &TerrainChunk::jobs_get_running_count);
 
 	ClassDB::bind_method(D_METHOD("get_voxel_world"), &TerrainChunk::get_voxel_world);
 	ClassDB::bind_method(D_METHOD("set_voxel_world", "world"), &TerrainChunk::set_voxel_world_bind);
@@ -1466,15 +2413,34 @@ void TerrainChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("channel_fill", "value", "index"), &TerrainChunk::channel_fill);
 	ClassDB::bind_method(D_METHOD("channel_dealloc", "index"), &TerrainChunk::channel_dealloc);
 
+	ClassDB::bind_method(D_METHOD("channel_is_uniform", "index"), &TerrainChunk::channel_is_uniform);
+	ClassDB::bind_method(D_METHOD("channel_get_uniform_value", "index"), &TerrainChunk::channel_get_uniform_value);
+	ClassDB::bind_method(D_METHOD("channel_compact", "index"), &TerrainChunk::channel_compact);
+	ClassDB::bind_method(D_METHOD("channels_compact"), &TerrainChunk::channels_compact);
+	ClassDB::bind_method(D_METHOD("get_channel_memory_usage"), &TerrainChunk::get_channel_memory_usage);
+
+	ClassDB::bind_method(D_METHOD("get_palette_channels"), &TerrainChunk::get_palette_channels);
+	ClassDB::bind_method(D_METHOD("set_palette_channels", "value"), &TerrainChunk::set_palette_channels);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "palette_channels"), "set_palette_channels", "get_palette_channels");
+
+	ClassDB::bind_method(D_METHOD("channel_is_palette_encoded", "index"), &TerrainChunk::channel_is_palette_encoded);
+	ClassDB::bind_method(D_METHOD("channel_get_palette", "index"), &TerrainChunk::channel_get_palette);
+
 	ClassDB::bind_method(D_METHOD("channel_get_array", "index"), &TerrainChunk::channel_get_array);
 	ClassDB::bind_method(D_METHOD("channel_set_array", "index", "array"), &TerrainChunk::channel_set_array);
 
 	ClassDB::bind_method(D_METHOD("channel_get_compressed", "index"), &TerrainChunk::channel_get_compressed);
 	ClassDB::bind_method(D_METHOD("channel_set_compressed", "index", "array"), &TerrainChunk::channel_set_compressed);
 
+	ClassDB::bind_method(D_METHOD("channel_get_compression_filter", "index"), &TerrainChunk::channel_get_compression_filter);
+	ClassDB::bind_method(D_METHOD("channel_get_compression_codec", "index"), &TerrainChunk::channel_get_compression_codec);
+	ClassDB::bind_method(D_METHOD("channel_set_compression", "index", "filter", "codec"), &TerrainChunk::channel_set_compression);
+	ClassDB::bind_method(D_METHOD("channel_benchmark_compression", "index", "passes"), &TerrainChunk::channel_benchmark_compression, DEFVAL(100));
+
 	ClassDB::bind_method(D_METHOD("get_index", "x", "z"), &TerrainChunk::get_index);
 	ClassDB::bind_method(D_METHOD("get_data_index", "x", "z"), &TerrainChunk::get_data_index);
 	ClassDB::bind_method(D_METHOD("get_data_size"), &TerrainChunk::get_data_size);
+	ClassDB::bind_method(D_METHOD("get_data_hash"), &TerrainChunk::get_data_hash);
 
 	ClassDB::bind_method(D_METHOD("voxel_structure_get", "index"), &TerrainChunk::voxel_structure_get);
 	ClassDB::bind_method(D_METHOD("voxel_structure_add", "structure"), &TerrainChunk::voxel_structure_add);
@@ -1554,9 +2520,23 @@ void TerrainChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_world_transform_changed"), &TerrainChunk::_world_transform_changed);
 	ClassDB::bind_method(D_METHOD("_enter_tree"), &TerrainChunk::_enter_tree);
 	ClassDB::bind_method(D_METHOD("_exit_tree"), &TerrainChunk::_exit_tree);
+	ClassDB::bind_method(D_METHOD("_recycle"), &TerrainChunk::_recycle);
 
 	ClassDB::bind_method(D_METHOD("_generation_process"), &TerrainChunk::_generation_process);
 	ClassDB::bind_method(D_METHOD("_generation_physics_process"), &TerrainChunk::_generation_physics_process);
 
 	ClassDB::bind_method(D_METHOD("is_safe_to_delete"), &TerrainChunk::is_safe_to_delete);
+
+	BIND_ENUM_CONSTANT(STREAMING_FLAG_COLLIDER);
+	BIND_ENUM_CONSTANT(STREAMING_FLAG_RENDER);
+	BIND_ENUM_CONSTANT(STREAMING_FLAGS_ALL);
+
+	BIND_ENUM_CONSTANT(CHANNEL_FILTER_NONE);
+	BIND_ENUM_CONSTANT(CHANNEL_FILTER_DELTA);
+	BIND_ENUM_CONSTANT(CHANNEL_FILTER_PREDICT_2D);
+
+	BIND_ENUM_CONSTANT(CHANNEL_CODEC_RAW);
+	BIND_ENUM_CONSTANT(CHANNEL_CODEC_RLE);
+	BIND_ENUM_CONSTANT(CHANNEL_CODEC_LZ4);
+	BIND_ENUM_CONSTANT(CHANNEL_CODEC_ZSTD);
 }
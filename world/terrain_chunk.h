@@ -48,6 +48,7 @@ include_pool_vector
 
 #include "scene/resources/packed_scene.h"
 
+#include "terrain_channel_codec.h"
 #include "terrain_world.h"
 
 #include "../data/terrain_light.h"
@@ -78,10 +79,33 @@ class TerrainChunk : public Resource {
 	_THREAD_SAFE_CLASS_
 
 public:
+	static const String BINDING_STRING_STREAMING_FLAGS;
+
 	enum {
 		TERRAIN_CHUNK_STATE_OK = 0,
 	};
 
+	//which parts of a chunk get built, set by TerrainWorld's streaming rings
+	enum StreamingFlags {
+		STREAMING_FLAG_COLLIDER = 1 << 0,
+		STREAMING_FLAG_RENDER = 1 << 1,
+
+		STREAMING_FLAGS_ALL = STREAMING_FLAG_COLLIDER | STREAMING_FLAG_RENDER,
+	};
+
+	enum ChannelFilter {
+		CHANNEL_FILTER_NONE = TerrainChannelCodec::FILTER_NONE,
+		CHANNEL_FILTER_DELTA = TerrainChannelCodec::FILTER_DELTA,
+		CHANNEL_FILTER_PREDICT_2D = TerrainChannelCodec::FILTER_PREDICT_2D,
+	};
+
+	enum ChannelCodec {
+		CHANNEL_CODEC_RAW = TerrainChannelCodec::CODEC_RAW,
+		CHANNEL_CODEC_RLE = TerrainChannelCodec::CODEC_RLE,
+		CHANNEL_CODEC_LZ4 = TerrainChannelCodec::CODEC_LZ4,
+		CHANNEL_CODEC_ZSTD = TerrainChannelCodec::CODEC_ZSTD,
+	};
+
 public:
 	bool get_process() const;
 	void set_process(const bool value);
@@ -95,6 +119,25 @@ public:
 	bool get_is_generating() const;
 	void set_is_generating(const bool value);
 
+	bool get_is_generation_pending() const;
+	void set_is_generation_pending(const bool value);
+
+	bool get_is_pooled() const;
+	void set_is_pooled(const bool value);
+
+	int get_streaming_flags() const;
+	void set_streaming_flags(const int value);
+
+	int get_collider_lod_level() const;
+	void set_collider_lod_level(const int value);
+
+	int get_world_index() const;
+	void set_world_index(const int value);
+
+	int get_active_set_index(const int set) const;
+	void set_active_set_index(const int set, const int index);
+	void active_sets_update();
+
 	bool is_build_aborted() const;
 
 	bool is_in_tree() const;
@@ -176,6 +219,12 @@ public:
 	void job_next();
 	Ref<TerrainJob> job_get_current();
 
+	void jobs_start();
+	void job_complete(const Ref<TerrainJob> &job);
+	bool job_is_running(const int index);
+	int jobs_get_running_count();
+	void job_submit(const Ref<TerrainJob> &job);
+
 	//Channels
 	void channel_setup();
 
@@ -189,7 +238,10 @@ public:
 	int channel_get_count() const;
 	void channel_set_count(const int count);
 
-	bool channel_is_allocated(const int channel_index);
+	int get_palette_channels() const;
+	void set_palette_channels(const int value);
+
+	bool channel_is_allocated(const int channel_index) const;
 	void channel_ensure_allocated(const int channel_index, const uint8_t default_value = 0);
 	void channel_allocate(const int channel_index, const uint8_t default_value = 0);
 	void channel_fill(const uint8_t value, const int channel_index);
@@ -198,16 +250,38 @@ public:
 	uint8_t *channel_get(const int channel_index);
 	uint8_t *channel_get_valid(const int channel_index, const uint8_t default_value = 0);
 
+	const uint8_t *channel_get_read(const int channel_index) const;
+	const uint8_t *channel_get_read_valid(const int channel_index, const uint8_t default_value = 0) const;
+
+	bool channel_is_uniform(const int channel_index) const;
+	int channel_get_uniform_value(const int channel_index) const;
+	void channel_compact(const int channel_index);
+	void channels_compact();
+	int get_channel_memory_usage() const;
+
+	bool channel_is_palette_encoded(const int channel_index) const;
+	PoolByteArray channel_get_palette(const int channel_index) const;
+	void channel_read_row(const int channel_index, const int z, uint8_t *r_row) const;
+	const uint8_t *channel_decode(const int channel_index, Vector<uint8_t> &r_storage) const;
+
 	PoolByteArray channel_get_array(const int channel_index) const;
 	void channel_set_array(const int channel_index, const PoolByteArray &array);
 
 	PoolByteArray channel_get_compressed(const int channel_index) const;
 	void channel_set_compressed(const int channel_index, const PoolByteArray &data);
 
+	int channel_get_compression_filter(const int channel_index) const;
+	int channel_get_compression_codec(const int channel_index) const;
+	void channel_set_compression(const int channel_index, const int filter, const int codec);
+	Array channel_benchmark_compression(const int channel_index, const int passes) const;
+
 	int get_index(const int x, const int z) const;
 	int get_data_index(const int x, const int z) const;
 	int get_data_size() const;
 
+	static uint64_t hash_buffer(const uint8_t *data, const int size, const uint64_t hash = 14695981039346656037ULL);
+	uint64_t get_data_hash() const;
+
 	//Terra Structures
 	Ref<TerrainStructure> voxel_structure_get(const int index) const;
 	void voxel_structure_add(const Ref<TerrainStructure> &structure);
@@ -291,10 +365,12 @@ public:
 	//handlers
 	void enter_tree();
 	void exit_tree();
+	void recycle();
 	void process(const float delta);
 	void physics_process(const float delta);
 	void world_transform_changed();
 	void visibility_changed(const bool visible);
+	void streaming_flags_changed(const int old_flags);
 	void world_light_added(const Ref<TerrainLight> &light);
 	void world_light_removed(const Ref<TerrainLight> &light);
 	void generation_process(const float delta);
@@ -315,10 +391,24 @@ public:
 protected:
 	virtual void _enter_tree();
 	virtual void _exit_tree();
+	virtual void _recycle();
 	virtual void _generation_process(const float delta);
 	virtual void _generation_physics_process(const float delta);
 
+	void job_start_index(const int index);
+	void job_cancel(const Ref<TerrainJob> &job);
+	bool job_is_queued(const Ref<TerrainJob> &job);
+	void job_complete_index(const int index);
+	bool job_index_depends_on(const int index, const int dependency_index) const;
+	int job_index_get_dependency_count(const int index) const;
+
 protected:
+	enum JobState {
+		JOB_STATE_WAITING = 0,
+		JOB_STATE_RUNNING,
+		JOB_STATE_DONE,
+	};
+
 #if PROPS_PRESENT
 	struct PropDataStore {
 		Transform transform;
@@ -344,9 +434,30 @@ protected:
 		RID shape_rid;
 	};
 
+	struct ChannelPalette {
+		//0 means the channel doesn't use a palette
+		int bits;
+		Vector<uint8_t> ids;
+		Vector<uint8_t> indices;
+
+		ChannelPalette() {
+			bits = 0;
+		}
+	};
+
 protected:
 	virtual void _world_transform_changed();
 
+	void channel_buffers_free();
+	void channel_buffer_release(const int channel_index);
+
+	static int get_palette_bits(const int id_count);
+	void channel_palette_encode(const int channel_index);
+	void channel_palette_repack(ChannelPalette &palette, const int bits);
+	void channel_palette_get_used(const int channel_index, bool *r_used) const;
+	void channel_palette_trim(const int channel_index);
+	bool channel_palette_set(const int channel_index, const int data_index, const uint8_t value);
+
 	/*
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -360,6 +471,12 @@ protected:
 	bool _is_visible;
 
 	bool _is_generating;
+	bool _is_generation_pending;
+	bool _is_pooled;
+	int _streaming_flags;
+	int _collider_lod_level;
+	int _world_index;
+	int _active_set_indices[TerrainWorld::CHUNK_ACTIVE_SET_MAX];
 	bool _dirty;
 	int _state;
 
@@ -390,12 +507,29 @@ protected:
 
 	float _world_height;
 
+	//only channels that need one have a buffer, each is a separate block from TerrainChannelAllocator,
+	//so giving a channel a buffer never moves the others
 	Vector<uint8_t *> _channels;
+	uint32_t _channel_buffer_size;
+
+	//channels that hold a single value don't have a buffer, -1 means not uniform
+	Vector<int> _channel_uniform;
+
+	//id channels with only a few different values can store them as packed indices into a palette
+	int _palette_channels;
+	Vector<ChannelPalette> _channel_palettes;
+
+	//how channel_get_compressed() encodes the channels
+	Vector<int> _channel_filters;
+	Vector<int> _channel_codecs;
 
 	float _voxel_scale;
 
-	int _current_job;
 	Vector<Ref<TerrainJob>> _jobs;
+	Vector<int> _job_states;
+	Vector<int> _job_pending_dependencies;
+	int _jobs_running;
+	int _jobs_remaining;
 
 	Ref<TerrainLibrary> _library;
 
@@ -417,4 +551,8 @@ protected:
 	bool _queued_generation;
 };
 
+VARIANT_ENUM_CAST(TerrainChunk::StreamingFlags);
+VARIANT_ENUM_CAST(TerrainChunk::ChannelFilter);
+VARIANT_ENUM_CAST(TerrainChunk::ChannelCodec);
+
 #endif
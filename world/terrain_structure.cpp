@@ -71,6 +71,12 @@ void TerrainStructure::write_to_chunk(Ref<TerrainChunk> chunk) {
 	}
 }
 
+bool TerrainStructure::is_thread_safe() const {
+	ScriptInstance *si = get_script_instance();
+
+	return !(si && si->has_method("_write_to_chunk"));
+}
+
 TerrainStructure::TerrainStructure() {
 	_use_aabb = true;
 	_position_x = 0;
@@ -111,4 +117,5 @@ void TerrainStructure::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_position", "x", "y", "z"), &TerrainStructure::set_position);
 
 	ClassDB::bind_method(D_METHOD("write_to_chunk", "chunk"), &TerrainStructure::write_to_chunk);
+	ClassDB::bind_method(D_METHOD("is_thread_safe"), &TerrainStructure::is_thread_safe);
 }
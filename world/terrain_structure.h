@@ -63,6 +63,9 @@ public:
 
 	void write_to_chunk(Ref<TerrainChunk> chunk);
 
+	//see TerrainLevelGenerator::is_thread_safe()
+	virtual bool is_thread_safe() const;
+
 #if VERSION_MAJOR >= 4
 	GDVIRTUAL1(_write_to_chunk, Ref<TerrainChunk>);
 #endif
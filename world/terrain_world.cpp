@@ -27,9 +27,28 @@ SOFTWARE.
 #include "core/message_queue.h"
 #include "terrain_chunk.h"
 #include "terrain_structure.h"
+#include "default/terrain_chunk_default.h"
+
+#include "jobs/terrain_generate_job.h"
+#include "jobs/terrain_worker_pool.h"
+#include "../meshers/terrain_mesher.h"
+
+#include "core/io/resource_saver.h"
+#include "scene/resources/packed_scene.h"
+
+#if VERSION_MAJOR > 3
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#else
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#endif
 
 #include "../defines.h"
 
+#include physics_server_h
+#include visual_server_h
+
 #if PROPS_PRESENT
 #include "../../props/props/prop_data.h"
 #include "../../props/props/prop_data_entry.h"
@@ -42,12 +61,22 @@ SOFTWARE.
 #include "../../mesh_data_resource/props/prop_data_mesh_data.h"
 #endif
 
+#if THREAD_POOL_PRESENT
+#include "../../thread_pool/thread_pool.h"
+#endif
+
+#if VERSION_MAJOR > 3
+#include "servers/display_server.h"
+#endif
+
 #if TOOLS_ENABLED
 #include "editor/plugins/spatial_editor_plugin.h"
 #include "scene/3d/camera.h"
 #endif
 
 const String TerrainWorld::BINDING_STRING_CHANNEL_TYPE_INFO = "Type,Isolevel,Liquid,Liquid Level";
+const String TerrainWorld::BINDING_STRING_STREAMING_RING = "Data,Collider,Render";
+const String TerrainWorld::BINDING_STRING_HEADLESS_MODE = "Auto,Off,On";
 
 bool TerrainWorld::get_active() const {
 	return _active;
@@ -107,6 +136,13 @@ void TerrainWorld::set_world_height(const float value) {
 	_world_height = value;
 }
 
+int TerrainWorld::get_palette_channels() const {
+	return _palette_channels;
+}
+void TerrainWorld::set_palette_channels(const int value) {
+	_palette_channels = value;
+}
+
 int TerrainWorld::get_max_concurrent_generations() {
 	return _max_concurrent_generations;
 }
@@ -114,6 +150,179 @@ void TerrainWorld::set_max_concurrent_generations(const int value) {
 	_max_concurrent_generations = value;
 }
 
+float TerrainWorld::get_generation_heading_bias() const {
+	return _generation_heading_bias;
+}
+void TerrainWorld::set_generation_heading_bias(const float value) {
+	_generation_heading_bias = value;
+}
+
+int TerrainWorld::get_generation_reprioritize_distance() const {
+	return _generation_reprioritize_distance;
+}
+void TerrainWorld::set_generation_reprioritize_distance(const int value) {
+	_generation_reprioritize_distance = value;
+}
+
+bool TerrainWorld::get_adaptive_generations() const {
+	return _adaptive_generations;
+}
+void TerrainWorld::set_adaptive_generations(const bool value) {
+	_adaptive_generations = value;
+	_adaptive_generations_timer = 0;
+}
+
+int TerrainWorld::get_adaptive_generations_min() const {
+	return _adaptive_generations_min;
+}
+void TerrainWorld::set_adaptive_generations_min(const int value) {
+	_adaptive_generations_min = MAX(value, 1);
+}
+
+int TerrainWorld::get_adaptive_generations_max() const {
+	return _adaptive_generations_max;
+}
+void TerrainWorld::set_adaptive_generations_max(const int value) {
+	_adaptive_generations_max = MAX(value, 0);
+}
+
+float TerrainWorld::get_adaptive_generations_target_latency() const {
+	return _adaptive_generations_target_latency;
+}
+void TerrainWorld::set_adaptive_generations_target_latency(const float value) {
+	_adaptive_generations_target_latency = value;
+}
+
+float TerrainWorld::get_adaptive_generations_interval() const {
+	return _adaptive_generations_interval;
+}
+void TerrainWorld::set_adaptive_generations_interval(const float value) {
+	_adaptive_generations_interval = value;
+}
+
+bool TerrainWorld::get_use_worker_threads() const {
+	return _use_worker_threads;
+}
+void TerrainWorld::set_use_worker_threads(const bool value) {
+	_use_worker_threads = value;
+}
+
+int TerrainWorld::get_worker_thread_count() const {
+	return _worker_thread_count;
+}
+void TerrainWorld::set_worker_thread_count(const int value) {
+	_worker_thread_count = MAX(value, 0);
+}
+
+bool TerrainWorld::get_use_mesher_pool() const {
+	return _use_mesher_pool;
+}
+void TerrainWorld::set_use_mesher_pool(const bool value) {
+	_use_mesher_pool = value;
+
+	if (!_use_mesher_pool) {
+		mesher_pool_clear();
+	}
+}
+
+TerrainWorld::HeadlessMode TerrainWorld::get_headless_mode() const {
+	return _headless_mode;
+}
+void TerrainWorld::set_headless_mode(const HeadlessMode value) {
+	_headless_mode = value;
+}
+
+bool TerrainWorld::is_headless() const {
+	if (_headless_mode != HEADLESS_MODE_AUTO) {
+		return _headless_mode == HEADLESS_MODE_ON;
+	}
+
+	if (Engine::get_singleton()->is_editor_hint()) {
+		return false;
+	}
+
+#if VERSION_MAJOR > 3
+	return DisplayServer::get_singleton() && DisplayServer::get_singleton()->get_name() == "headless";
+#else
+	return OS::get_singleton()->has_feature("Server");
+#endif
+}
+
+bool TerrainWorld::get_use_chunk_pool() const {
+	return _use_chunk_pool;
+}
+void TerrainWorld::set_use_chunk_pool(const bool value) {
+	_use_chunk_pool = value;
+
+	if (!_use_chunk_pool) {
+		chunk_pool_clear();
+	}
+}
+
+int TerrainWorld::get_chunk_pool_max_size() const {
+	return _chunk_pool_max_size;
+}
+void TerrainWorld::set_chunk_pool_max_size(const int value) {
+	_chunk_pool_max_size = MAX(value, 0);
+
+	while (_chunk_pool.size() > _chunk_pool_max_size) {
+		Ref<TerrainChunk> chunk = _chunk_pool[_chunk_pool.size() - 1];
+		_chunk_pool.resize(_chunk_pool.size() - 1);
+
+		chunk->set_is_pooled(false);
+		chunk->set_voxel_world(NULL);
+	}
+}
+
+String TerrainWorld::get_adaptive_generations_reason() const {
+	return _adaptive_generations_reason;
+}
+float TerrainWorld::get_generation_latency() const {
+	return _generation_latency;
+}
+int TerrainWorld::get_generation_worker_count() const {
+#if THREAD_POOL_PRESENT
+	ThreadPool *pool = ThreadPool::get_singleton();
+
+	//without threads the pool runs its jobs on the main thread
+	if (!pool || !pool->get_use_threads()) {
+		return 1;
+	}
+
+	return MAX(pool->get_thread_count(), 1);
+#else
+	return MAX(_worker_pool->get_thread_count(), 1);
+#endif
+}
+
+int TerrainWorld::get_max_frame_chunk_build_steps() const {
+	return _max_frame_chunk_build_steps;
+}
+void TerrainWorld::set_max_frame_chunk_build_steps(const int value) {
+	_max_frame_chunk_build_steps = value;
+}
+
+int TerrainWorld::get_process_build_budget_usec() const {
+	return _process_build_budget_usec;
+}
+void TerrainWorld::set_process_build_budget_usec(const int value) {
+	_process_build_budget_usec = value;
+}
+
+int TerrainWorld::get_physics_process_build_budget_usec() const {
+	return _physics_process_build_budget_usec;
+}
+void TerrainWorld::set_physics_process_build_budget_usec(const int value) {
+	_physics_process_build_budget_usec = value;
+}
+
+float TerrainWorld::get_build_step_cost_smoothing() const {
+	return _build_step_cost_smoothing;
+}
+void TerrainWorld::set_build_step_cost_smoothing(const float value) {
+	_build_step_cost_smoothing = CLAMP(value, 0.0, 1.0);
+}
+
 Ref<TerrainLibrary> TerrainWorld::get_library() {
 	return _library;
 }
@@ -154,10 +363,10 @@ void TerrainWorld::set_voxel_scale(const float value) {
 }
 
 int TerrainWorld::get_chunk_spawn_range() const {
-	return _chunk_spawn_range;
+	return _streaming_rings[STREAMING_RING_RENDER].range;
 }
 void TerrainWorld::set_chunk_spawn_range(const int value) {
-	_chunk_spawn_range = value;
+	streaming_ring_set_range(STREAMING_RING_RENDER, value);
 }
 
 NodePath TerrainWorld::get_player_path() const {
@@ -173,232 +382,1207 @@ Spatial *TerrainWorld::get_player() const {
 }
 void TerrainWorld::set_player(Spatial *player) {
 	_player = player;
+
+	streaming_invalidate();
 }
 void TerrainWorld::set_player_bind(Node *player) {
 	set_player(Object::cast_to<Spatial>(player));
 }
 
-Ref<TerrainWorldArea> TerrainWorld::world_area_get(const int index) const {
-	ERR_FAIL_INDEX_V(index, _world_areas.size(), Ref<TerrainWorldArea>());
-
-	return _world_areas.get(index);
-}
-void TerrainWorld::world_area_add(const Ref<TerrainWorldArea> &area) {
-	_world_areas.push_back(area);
+bool TerrainWorld::get_streaming() const {
+	return _streaming;
 }
-void TerrainWorld::world_area_remove(const int index) {
-	ERR_FAIL_INDEX(index, _world_areas.size());
+void TerrainWorld::set_streaming(const bool value) {
+	_streaming = value;
 
-	_world_areas.VREMOVE(index);
-}
-void TerrainWorld::world_areas_clear() {
-	_world_areas.clear();
+	streaming_invalidate();
 }
-int TerrainWorld::world_area_get_count() const {
-	return _world_areas.size();
+
+int TerrainWorld::get_streaming_despawn_margin() const {
+	return _streaming_despawn_margin;
 }
+void TerrainWorld::set_streaming_despawn_margin(const int value) {
+	_streaming_despawn_margin = value;
 
-//Terra Structures
+	streaming_invalidate();
+}
 
-Ref<TerrainStructure> TerrainWorld::voxel_structure_get(const int index) const {
-	ERR_FAIL_INDEX_V(index, _voxel_structures.size(), Ref<TerrainStructure>());
+int TerrainWorld::streaming_ring_get_range(const int ring) const {
+	ERR_FAIL_INDEX_V(ring, STREAMING_RING_MAX, 0);
 
-	return _voxel_structures.get(index);
-}
-void TerrainWorld::voxel_structure_add(const Ref<TerrainStructure> &structure) {
-	_voxel_structures.push_back(structure);
+	return _streaming_rings[ring].range;
 }
-void TerrainWorld::voxel_structure_remove(const Ref<TerrainStructure> &structure) {
-	if (!structure.is_valid())
-		return;
+void TerrainWorld::streaming_ring_set_range(const int ring, const int value) {
+	ERR_FAIL_INDEX(ring, STREAMING_RING_MAX);
 
-	int index = _voxel_structures.find(structure);
+	_streaming_rings[ring].range = value;
 
-	if (index != -1)
-		_voxel_structures.VREMOVE(index);
+	streaming_invalidate();
 }
-void TerrainWorld::voxel_structure_remove_index(const int index) {
-	ERR_FAIL_INDEX(index, _voxel_structures.size());
 
-	_voxel_structures.VREMOVE(index);
-}
-void TerrainWorld::voxel_structures_clear() {
-	_voxel_structures.clear();
+int TerrainWorld::streaming_ring_get_spawn_budget(const int ring) const {
+	ERR_FAIL_INDEX_V(ring, STREAMING_RING_MAX, 0);
+
+	return _streaming_rings[ring].spawn_budget;
 }
-int TerrainWorld::voxel_structure_get_count() const {
-	return _voxel_structures.size();
+void TerrainWorld::streaming_ring_set_spawn_budget(const int ring, const int value) {
+	ERR_FAIL_INDEX(ring, STREAMING_RING_MAX);
+
+	_streaming_rings[ring].spawn_budget = value;
 }
-void TerrainWorld::voxel_structure_add_at_position(Ref<TerrainStructure> structure, const Vector3 &world_position) {
-	ERR_FAIL_COND(!structure.is_valid());
 
-	structure->set_position_x(static_cast<int>(world_position.x / _voxel_scale));
-	structure->set_position_y(static_cast<int>(world_position.y / _voxel_scale));
-	structure->set_position_z(static_cast<int>(world_position.z / _voxel_scale));
+int TerrainWorld::streaming_ring_get_despawn_budget(const int ring) const {
+	ERR_FAIL_INDEX_V(ring, STREAMING_RING_MAX, 0);
 
-	voxel_structure_add(structure);
+	return _streaming_rings[ring].despawn_budget;
 }
+void TerrainWorld::streaming_ring_set_despawn_budget(const int ring, const int value) {
+	ERR_FAIL_INDEX(ring, STREAMING_RING_MAX);
 
-Vector<Variant> TerrainWorld::voxel_structures_get() {
-	VARIANT_ARRAY_GET(_voxel_structures);
+	_streaming_rings[ring].despawn_budget = value;
 }
-void TerrainWorld::voxel_structures_set(const Vector<Variant> &structures) {
-	voxel_structures_clear();
 
-	for (int i = 0; i < structures.size(); ++i) {
-		Ref<TerrainLight> structure = Ref<TerrainLight>(structures[i]);
+int TerrainWorld::streaming_get_chunk_flags(const int x, const int z) const {
+	if (!_streaming_has_center) {
+		if (is_headless()) {
+			return TerrainChunk::STREAMING_FLAG_COLLIDER;
+		}
 
-		voxel_structure_add(structure);
+		return TerrainChunk::STREAMING_FLAGS_ALL;
 	}
-}
 
-void TerrainWorld::chunk_add(Ref<TerrainChunk> chunk, const int x, const int z) {
-	ERR_FAIL_COND(!chunk.is_valid());
-	ERR_FAIL_COND_MSG(chunk->get_voxel_world() != NULL && chunk->get_voxel_world() != this, "Chunk is already owned by an another world!");
+	int dx = x - _streaming_center.x;
+	int dz = z - _streaming_center.z;
+	int d = dx * dx + dz * dz;
 
-	IntPos pos(x, z);
+	int flags = 0;
 
-	//ERR_FAIL_COND(_chunks.has(pos));
+	int r = streaming_ring_get_effective_range(STREAMING_RING_COLLIDER);
 
-	chunk->set_voxel_world(this);
-	chunk->set_position(x, z);
-	chunk->world_transform_changed();
+	if (d <= r * r || collider_anchor_is_near(x, z)) {
+		flags |= TerrainChunk::STREAMING_FLAG_COLLIDER;
+	}
 
-	if (!_chunks.has(pos))
-		_chunks.set(pos, chunk);
+	r = streaming_ring_get_effective_range(STREAMING_RING_RENDER);
 
-	if (_chunks_vector.find(chunk) == -1)
-		_chunks_vector.push_back(chunk);
+	if (d <= r * r && !is_headless()) {
+		flags |= TerrainChunk::STREAMING_FLAG_RENDER;
+	}
 
-	if (is_inside_tree())
-		chunk->enter_tree();
+	return flags;
+}
 
-	if (has_method("_chunk_added")) {
-		CALL(_chunk_added, chunk);
+int TerrainWorld::streaming_get_chunk_collider_lod_level(const int x, const int z) const {
+	if (_collider_lod_range <= 0 || !_streaming_has_center || collider_anchor_is_near(x, z)) {
+		return 0;
 	}
 
-	emit_signal("chunk_added", chunk);
-}
-bool TerrainWorld::chunk_has(const int x, const int z) const {
-	return _chunks.has(IntPos(x, z));
-}
-Ref<TerrainChunk> TerrainWorld::chunk_get(const int x, const int z) {
-	IntPos pos(x, z);
+	int dx = x - _streaming_center.x;
+	int dz = z - _streaming_center.z;
 
-	if (_chunks.has(pos))
-		return _chunks.get(pos);
+	return dx * dx + dz * dz > _collider_lod_range * _collider_lod_range ? 1 : 0;
+}
 
-	return Ref<TerrainChunk>();
+void TerrainWorld::streaming_invalidate() {
+	_streaming_dirty = true;
+	_streaming_has_center = false;
 }
-Ref<TerrainChunk> TerrainWorld::chunk_remove(const int x, const int z) {
-	IntPos pos(x, z);
 
-	if (!_chunks.has(pos)) {
-		return NULL;
+void TerrainWorld::streaming_update() {
+	if (!_player || !INSTANCE_VALIDATE(_player)) {
+		return;
 	}
 
-	Ref<TerrainChunk> chunk = _chunks.get(pos);
+	Vector3 ppos = get_global_transform().affine_inverse().xform(_player->get_global_transform().origin);
 
-	chunk->exit_tree();
+	IntPos center(static_cast<int>(Math::floor(ppos.x / (_chunk_size_x * _voxel_scale))),
+			static_cast<int>(Math::floor(ppos.z / (_chunk_size_z * _voxel_scale))));
 
-	for (int i = 0; i < _chunks_vector.size(); ++i) {
-		if (_chunks_vector.get(i) == chunk) {
-			_chunks_vector.VREMOVE(i);
-			break;
-		}
+	if (!_streaming_has_center || !(center == _streaming_center)) {
+		_streaming_center = center;
+		_streaming_has_center = true;
+		_streaming_dirty = true;
 	}
 
-	_generation_queue.erase(chunk);
+	if (_streaming_dirty) {
+		_streaming_dirty = false;
 
-	if (chunk->get_is_generating()) {
-		chunk->cancel_build();
-	}
+		int range = streaming_ring_get_effective_range(STREAMING_RING_DATA);
 
-	//never remove from this here
-	//_generating.erase(chunk);
+		if (range != _streaming_offsets_range) {
+			_streaming_offsets_range = range;
+			_streaming_offsets.clear();
 
-	_chunks.erase(pos);
+			for (int z = -range; z <= range; ++z) {
+				for (int x = -range; x <= range; ++x) {
+					if (x * x + z * z <= range * range) {
+						_streaming_offsets.push_back(IntPos(x, z));
+					}
+				}
+			}
 
-	emit_signal("chunk_removed", chunk);
+			_streaming_offsets.sort_custom<IntPosDistanceComparator>();
+		}
 
-	return chunk;
-}
-Ref<TerrainChunk> TerrainWorld::chunk_remove_index(const int index) {
-	ERR_FAIL_INDEX_V(index, _chunks_vector.size(), NULL);
+		for (int i = 0; i < STREAMING_RING_MAX; ++i) {
+			_streaming_rings[i].spawn_cursor = 0;
+			_streaming_rings[i].spawn_done = false;
+		}
 
-	Ref<TerrainChunk> chunk = _chunks_vector.get(index);
-	chunk->exit_tree();
+		streaming_collect_despawns();
+		streaming_update_collider_lods();
+	}
 
-	_chunks_vector.VREMOVE(index);
-	_chunks.erase(IntPos(chunk->get_position_x(), chunk->get_position_z()));
-	_generation_queue.erase(chunk);
+	collider_anchors_update();
 
-	if (chunk->get_is_generating()) {
-		chunk->cancel_build();
+	//despawn first, so budgets don't fight each other
+	for (int i = 0; i < STREAMING_RING_MAX; ++i) {
+		streaming_ring_despawn(i);
 	}
 
-	//never remove from this here
-	//_generating.erase(chunk);
+	for (int i = 0; i < STREAMING_RING_MAX; ++i) {
+		streaming_ring_spawn(i);
+	}
+}
 
-	emit_signal("chunk_removed", chunk);
+int TerrainWorld::streaming_ring_get_effective_range(const int ring) const {
+	if (ring == STREAMING_RING_DATA) {
+		//the data ring always has to contain the others
+		return MAX(_streaming_rings[STREAMING_RING_DATA].range, MAX(_streaming_rings[STREAMING_RING_COLLIDER].range, _streaming_rings[STREAMING_RING_RENDER].range));
+	}
 
-	return chunk;
+	return _streaming_rings[ring].range;
 }
 
-Ref<TerrainChunk> TerrainWorld::chunk_get_index(const int index) {
-	ERR_FAIL_INDEX_V(index, _chunks_vector.size(), NULL);
+void TerrainWorld::streaming_collect_despawns() {
+	for (int i = 0; i < STREAMING_RING_MAX; ++i) {
+		_streaming_rings[i].despawn_queue.clear();
+	}
 
-	return _chunks_vector.get(index);
-}
-int TerrainWorld::chunk_get_count() const {
-	return _chunks_vector.size();
-}
+	int limits[STREAMING_RING_MAX];
+
+	for (int i = 0; i < STREAMING_RING_MAX; ++i) {
+		int r = streaming_ring_get_effective_range(i) + _streaming_despawn_margin;
+		limits[i] = r * r;
+	}
 
-void TerrainWorld::chunks_clear() {
 	for (int i = 0; i < _chunks_vector.size(); ++i) {
-		Ref<TerrainChunk> chunk = _chunks_vector.get(i);
+		Ref<TerrainChunk> chunk = _chunks_vector[i];
 
-		chunk->exit_tree();
+		ERR_CONTINUE(!chunk.is_valid());
 
-		emit_signal("chunk_removed", chunk);
-	}
+		IntPos rel(chunk->get_position_x() - _streaming_center.x, chunk->get_position_z() - _streaming_center.z);
+		int d = rel.x * rel.x + rel.z * rel.z;
 
-	_chunks_vector.clear();
-	_chunks.clear();
-	_generation_queue.clear();
+		if (d > limits[STREAMING_RING_DATA]) {
+			_streaming_rings[STREAMING_RING_DATA].despawn_queue.push_back(rel);
+			continue;
+		}
 
-	for (int i = 0; i < _generating.size(); ++i) {
-		Ref<TerrainChunk> chunk = _generating[i];
+		int flags = chunk->get_streaming_flags();
 
-		if (chunk->get_is_generating()) {
-			chunk->cancel_build();
+		if ((flags & TerrainChunk::STREAMING_FLAG_COLLIDER) != 0 && d > limits[STREAMING_RING_COLLIDER] && !collider_anchor_is_near(chunk->get_position_x(), chunk->get_position_z(), _streaming_despawn_margin)) {
+			_streaming_rings[STREAMING_RING_COLLIDER].despawn_queue.push_back(rel);
+		}
+
+		if ((flags & TerrainChunk::STREAMING_FLAG_RENDER) != 0 && d > limits[STREAMING_RING_RENDER]) {
+			_streaming_rings[STREAMING_RING_RENDER].despawn_queue.push_back(rel);
 		}
 	}
 
-	//never remove from this here
-	//_generating.clear();
+	//they get processed from the back, farthest first
+	for (int i = 0; i < STREAMING_RING_MAX; ++i) {
+		_streaming_rings[i].despawn_queue.sort_custom<IntPosDistanceComparator>();
+	}
 }
 
-Ref<TerrainChunk> TerrainWorld::chunk_get_or_create(int x, int z) {
-	Ref<TerrainChunk> chunk = chunk_get(x, z);
-
-	if (!chunk.is_valid()) {
-		chunk = chunk_create(x, z);
+void TerrainWorld::streaming_update_collider_lods() {
+	if (_collider_lod_range <= 0) {
+		return;
 	}
 
-	return chunk;
-}
+	int r = _collider_lod_range + _streaming_despawn_margin;
+	int limit = r * r;
 
-Ref<TerrainChunk> TerrainWorld::chunk_create(const int x, const int z) {
-	Ref<TerrainChunk> c;
-	GET_CALLP(Ref<TerrainChunk>, c, _create_chunk, x, z, Ref<TerrainChunk>());
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		Ref<TerrainChunk> chunk = _chunks_vector[i];
 
-	generation_queue_add_to(c);
+		ERR_CONTINUE(!chunk.is_valid());
 
-	return c;
-}
+		//the lod is only used by heightmap colliders, other chunks would just get rebuilt for nothing
+		Ref<TerrainChunkDefault> cd = chunk;
 
-void TerrainWorld::chunk_setup(Ref<TerrainChunk> chunk) {
-	ERR_FAIL_COND(!chunk.is_valid());
+		if (!cd.is_valid() || (cd->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_CREATE_COLLIDER) == 0 || (cd->get_build_flags() & TerrainChunkDefault::BUILD_FLAG_HEIGHTMAP_COLLIDER) == 0) {
+			continue;
+		}
+
+		int x = chunk->get_position_x();
+		int z = chunk->get_position_z();
+		int dx = x - _streaming_center.x;
+		int dz = z - _streaming_center.z;
+
+		int lod = streaming_get_chunk_collider_lod_level(x, z);
+
+		//only go lower after the despawn margin, so chunks on the border don't keep getting rebuilt
+		if (lod > chunk->get_collider_lod_level() && dx * dx + dz * dz <= limit) {
+			continue;
+		}
+
+		if (lod == chunk->get_collider_lod_level()) {
+			continue;
+		}
+
+		chunk->set_collider_lod_level(lod);
+
+		//chunks that are building / queued will use the new lod anyway
+		if ((chunk->get_streaming_flags() & TerrainChunk::STREAMING_FLAG_COLLIDER) != 0 && !chunk->get_is_generating() && !chunk->get_is_generation_pending()) {
+			chunk->build();
+		}
+	}
+}
+
+void TerrainWorld::streaming_ring_spawn(const int ring_index) {
+	StreamingRingData &ring = _streaming_rings[ring_index];
+
+	if (ring.spawn_done) {
+		return;
+	}
+
+	if (ring_index == STREAMING_RING_RENDER && is_headless()) {
+		ring.spawn_done = true;
+		return;
+	}
+
+	int range = streaming_ring_get_effective_range(ring_index);
+	int range_sq = range * range;
+
+	int flag = 0;
+
+	if (ring_index == STREAMING_RING_COLLIDER) {
+		flag = TerrainChunk::STREAMING_FLAG_COLLIDER;
+	} else if (ring_index == STREAMING_RING_RENDER) {
+		flag = TerrainChunk::STREAMING_FLAG_RENDER;
+	}
+
+	int count = 0;
+	int first_waiting = -1;
+	int i = ring.spawn_cursor;
+
+	for (; i < _streaming_offsets.size(); ++i) {
+		const IntPos &o = _streaming_offsets[i];
+
+		if (o.x * o.x + o.z * o.z > range_sq) {
+			break;
+		}
+
+		if (ring.spawn_budget > 0 && count >= ring.spawn_budget) {
+			//out of budget, continue next frame
+			ring.spawn_cursor = first_waiting != -1 ? first_waiting : i;
+			return;
+		}
+
+		int x = _streaming_center.x + o.x;
+		int z = _streaming_center.z + o.z;
+
+		if (ring_index == STREAMING_RING_DATA) {
+			if (chunk_has(x, z)) {
+				continue;
+			}
+
+			Ref<TerrainChunk> chunk = chunk_create(x, z);
+
+			if (chunk.is_valid()) {
+				chunk->set_streaming_flags(streaming_get_chunk_flags(x, z));
+				chunk->set_collider_lod_level(streaming_get_chunk_collider_lod_level(x, z));
+			}
+
+			++count;
+			continue;
+		}
+
+		Ref<TerrainChunk> chunk = chunk_get(x, z);
+
+		if (!chunk.is_valid() || chunk->get_is_generating()) {
+			//wait for the data ring / the current build
+			if (first_waiting == -1) {
+				first_waiting = i;
+			}
+
+			continue;
+		}
+
+		if ((chunk->get_streaming_flags() & flag) != 0) {
+			continue;
+		}
+
+		chunk->set_streaming_flags(chunk->get_streaming_flags() | flag);
+
+		if (flag == TerrainChunk::STREAMING_FLAG_COLLIDER) {
+			chunk->set_collider_lod_level(streaming_get_chunk_collider_lod_level(x, z));
+		}
+
+		//queued chunks will get built after generation anyway
+		if (!chunk->get_is_generation_pending()) {
+			chunk->build();
+		}
+
+		++count;
+	}
+
+	if (first_waiting != -1) {
+		ring.spawn_cursor = first_waiting;
+		return;
+	}
+
+	ring.spawn_done = true;
+}
+
+void TerrainWorld::streaming_ring_despawn(const int ring_index) {
+	StreamingRingData &ring = _streaming_rings[ring_index];
+
+	int count = 0;
+
+	while (ring.despawn_queue.size() > 0 && (ring.despawn_budget <= 0 || count < ring.despawn_budget)) {
+		IntPos rel = ring.despawn_queue[ring.despawn_queue.size() - 1];
+		ring.despawn_queue.resize(ring.despawn_queue.size() - 1);
+
+		int x = _streaming_center.x + rel.x;
+		int z = _streaming_center.z + rel.z;
+
+		Ref<TerrainChunk> chunk = chunk_get(x, z);
+
+		if (!chunk.is_valid()) {
+			continue;
+		}
+
+		if (ring_index == STREAMING_RING_DATA) {
+			chunk_remove(x, z);
+			++count;
+			continue;
+		}
+
+		int flag = ring_index == STREAMING_RING_COLLIDER ? TerrainChunk::STREAMING_FLAG_COLLIDER : TerrainChunk::STREAMING_FLAG_RENDER;
+
+		if ((chunk->get_streaming_flags() & flag) == 0) {
+			continue;
+		}
+
+		//an anchor might have moved close to it since the despawns got collected
+		if (flag == TerrainChunk::STREAMING_FLAG_COLLIDER && collider_anchor_is_near(x, z, _streaming_despawn_margin)) {
+			continue;
+		}
+
+		chunk->set_streaming_flags(chunk->get_streaming_flags() & ~flag);
+		++count;
+	}
+}
+
+int TerrainWorld::get_collider_lod_range() const {
+	return _collider_lod_range;
+}
+void TerrainWorld::set_collider_lod_range(const int value) {
+	_collider_lod_range = value;
+
+	streaming_invalidate();
+}
+
+int TerrainWorld::get_collider_anchor_range() const {
+	return _collider_anchor_range;
+}
+void TerrainWorld::set_collider_anchor_range(const int value) {
+	_collider_anchor_range = MAX(value, 0);
+	_collider_anchors_dirty = true;
+}
+
+void TerrainWorld::collider_anchor_add(Node *node) {
+	ERR_FAIL_COND(!Object::cast_to<Spatial>(node));
+
+	if (_collider_anchors.find(node->get_instance_id()) != -1) {
+		return;
+	}
+
+	_collider_anchors.push_back(node->get_instance_id());
+	_collider_anchors_dirty = true;
+}
+void TerrainWorld::collider_anchor_remove(Node *node) {
+	ERR_FAIL_COND(!node);
+
+	int index = _collider_anchors.find(node->get_instance_id());
+
+	if (index == -1) {
+		return;
+	}
+
+	_collider_anchors.VREMOVE(index);
+	_collider_anchors_dirty = true;
+}
+int TerrainWorld::collider_anchor_get_count() const {
+	return _collider_anchors.size();
+}
+void TerrainWorld::collider_anchors_clear() {
+	_collider_anchors.clear();
+	_collider_anchors_dirty = true;
+}
+bool TerrainWorld::collider_anchor_is_near(const int x, const int z, const int margin) const {
+	int r = _collider_anchor_range + margin;
+
+	for (int i = 0; i < _collider_anchor_positions.size(); ++i) {
+		const IntPos &p = _collider_anchor_positions[i];
+
+		int dx = x - p.x;
+		int dz = z - p.z;
+
+		if (dx * dx + dz * dz <= r * r) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//gives colliders to the chunks around the anchors, and takes them away when they move on
+void TerrainWorld::collider_anchors_update() {
+	Vector<IntPos> positions;
+
+	for (int i = _collider_anchors.size() - 1; i >= 0; --i) {
+		Spatial *anchor = Object::cast_to<Spatial>(ObjectDB::get_instance(_collider_anchors[i]));
+
+		if (!anchor) {
+			//freed
+			_collider_anchors.VREMOVE(i);
+			_collider_anchors_dirty = true;
+			continue;
+		}
+
+		if (!anchor->is_inside_tree()) {
+			continue;
+		}
+
+		Vector3 pos = get_global_transform().affine_inverse().xform(anchor->get_global_transform().origin);
+
+		positions.push_back(IntPos(static_cast<int>(Math::floor(pos.x / (_chunk_size_x * _voxel_scale))),
+				static_cast<int>(Math::floor(pos.z / (_chunk_size_z * _voxel_scale)))));
+	}
+
+	bool changed = _collider_anchors_dirty || positions.size() != _collider_anchor_positions.size();
+
+	for (int i = 0; !changed && i < positions.size(); ++i) {
+		changed = !(positions[i] == _collider_anchor_positions[i]);
+	}
+
+	if (!changed) {
+		return;
+	}
+
+	_collider_anchor_positions = positions;
+	_collider_anchors_dirty = false;
+
+	int r = streaming_ring_get_effective_range(STREAMING_RING_COLLIDER) + _streaming_despawn_margin;
+	int ring_limit = r * r;
+
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		Ref<TerrainChunk> chunk = _chunks_vector[i];
+
+		ERR_CONTINUE(!chunk.is_valid());
+
+		int x = chunk->get_position_x();
+		int z = chunk->get_position_z();
+		int flags = chunk->get_streaming_flags();
+
+		if ((flags & TerrainChunk::STREAMING_FLAG_COLLIDER) == 0) {
+			if (!collider_anchor_is_near(x, z)) {
+				continue;
+			}
+
+			if (chunk->get_is_generating()) {
+				//try again next frame
+				_collider_anchors_dirty = true;
+				continue;
+			}
+
+			chunk->set_streaming_flags(flags | TerrainChunk::STREAMING_FLAG_COLLIDER);
+			chunk->set_collider_lod_level(0);
+
+			if (!chunk->get_is_generation_pending()) {
+				chunk->build();
+			}
+
+			continue;
+		}
+
+		if (!_streaming_has_center || collider_anchor_is_near(x, z, _streaming_despawn_margin)) {
+			continue;
+		}
+
+		int dx = x - _streaming_center.x;
+		int dz = z - _streaming_center.z;
+
+		//still in the player's collider ring
+		if (dx * dx + dz * dz <= ring_limit) {
+			continue;
+		}
+
+		chunk->set_streaming_flags(flags & ~TerrainChunk::STREAMING_FLAG_COLLIDER);
+	}
+}
+
+int TerrainWorld::get_collider_region_size() const {
+	return _collider_region_size;
+}
+void TerrainWorld::set_collider_region_size(const int value) {
+	//chunks remember which body they were added to, so existing colliders stay valid
+	_collider_region_size = MAX(value, 0);
+}
+
+RID TerrainWorld::collider_region_shape_add(const int chunk_x, const int chunk_z, const RID &shape, const Transform &transform, const int layer_mask) {
+	ERR_FAIL_COND_V(_collider_region_size <= 0, RID());
+
+	IntPos pos(static_cast<int>(Math::floor(chunk_x / static_cast<float>(_collider_region_size))),
+			static_cast<int>(Math::floor(chunk_z / static_cast<float>(_collider_region_size))));
+
+	int index = -1;
+
+	for (int i = 0; i < _collider_regions.size(); ++i) {
+		if (_collider_regions[i].position == pos) {
+			index = i;
+			break;
+		}
+	}
+
+	if (index == -1) {
+		ColliderRegion region;
+		region.position = pos;
+		region.body = PhysicsServer::get_singleton()->body_create(PhysicsServer::BODY_MODE_STATIC);
+
+		//the layers of the first shape are used for the whole region
+		PhysicsServer::get_singleton()->body_set_collision_layer(region.body, layer_mask);
+		PhysicsServer::get_singleton()->body_set_collision_mask(region.body, layer_mask);
+		PhysicsServer::get_singleton()->body_set_state(region.body, PhysicsServer::BODY_STATE_TRANSFORM, get_transform());
+
+		if (is_inside_tree() && is_inside_world()) {
+			Ref<World> world = GET_WORLD();
+
+			if (world.is_valid() && world->get_space() != RID())
+				PhysicsServer::get_singleton()->body_set_space(region.body, world->get_space());
+		}
+
+		_collider_regions.push_back(region);
+		index = _collider_regions.size() - 1;
+	}
+
+	ColliderRegion &region = _collider_regions.write[index];
+
+	PhysicsServer::get_singleton()->body_add_shape(region.body, shape, transform);
+	region.shapes.push_back(shape);
+
+	return region.body;
+}
+void TerrainWorld::collider_region_shape_remove(const RID &body, const RID &shape) {
+	for (int i = 0; i < _collider_regions.size(); ++i) {
+		ColliderRegion &region = _collider_regions.write[i];
+
+		if (region.body != body) {
+			continue;
+		}
+
+		int index = region.shapes.find(shape);
+
+		ERR_FAIL_COND(index == -1);
+
+		//the physics server shifts the indices of the following shapes the same way
+		PhysicsServer::get_singleton()->body_remove_shape(region.body, index);
+		region.shapes.VREMOVE(index);
+
+		if (region.shapes.size() == 0) {
+			PhysicsServer::get_singleton()->free(region.body);
+			_collider_regions.VREMOVE(i);
+		}
+
+		return;
+	}
+}
+void TerrainWorld::collider_region_shape_set_transform(const RID &body, const RID &shape, const Transform &transform) {
+	for (int i = 0; i < _collider_regions.size(); ++i) {
+		const ColliderRegion &region = _collider_regions[i];
+
+		if (region.body != body) {
+			continue;
+		}
+
+		int index = region.shapes.find(shape);
+
+		ERR_FAIL_COND(index == -1);
+
+		PhysicsServer::get_singleton()->body_set_shape_transform(region.body, index, transform);
+		return;
+	}
+}
+int TerrainWorld::collider_region_get_count() const {
+	return _collider_regions.size();
+}
+void TerrainWorld::collider_regions_clear() {
+	//the shapes belong to the chunks
+	for (int i = 0; i < _collider_regions.size(); ++i) {
+		PhysicsServer::get_singleton()->free(_collider_regions[i].body);
+	}
+
+	_collider_regions.clear();
+}
+
+String TerrainWorld::get_mesh_cache_path() const {
+	return _mesh_cache_path;
+}
+void TerrainWorld::set_mesh_cache_path(const String &value) {
+	_mesh_cache_path = value;
+}
+
+//edits in the editor would just keep filling it up
+bool TerrainWorld::mesh_cache_is_enabled() const {
+	return _mesh_cache_path != "" && !Engine::get_singleton()->is_editor_hint();
+}
+String TerrainWorld::mesh_cache_get_file_path(const String &key) const {
+#if VERSION_MAJOR < 4
+	return _mesh_cache_path.plus_file(key + ".tmc");
+#else
+	return _mesh_cache_path.path_join(key + ".tmc");
+#endif
+}
+//called from the worker threads
+Dictionary TerrainWorld::mesh_cache_load(const String &key) const {
+	String path = mesh_cache_get_file_path(key);
+
+	if (!FileAccess::exists(path)) {
+		return Dictionary();
+	}
+
+#if VERSION_MAJOR < 4
+	FileAccess *f = FileAccess::open(path, FileAccess::READ);
+
+	if (!f) {
+		return Dictionary();
+	}
+
+	Variant entry = f->get_var();
+
+	memdelete(f);
+#else
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+
+	if (f.is_null()) {
+		return Dictionary();
+	}
+
+	Variant entry = f->get_var();
+#endif
+
+	if (entry.get_type() != Variant::DICTIONARY) {
+		return Dictionary();
+	}
+
+	//files that got cut short or were written by something else count as a miss
+	Dictionary d = entry;
+
+	if (d.get("meshes", Variant()).get_type() != Variant::ARRAY) {
+		return Dictionary();
+	}
+
+	Array meshes = d["meshes"];
+
+	for (int i = 0; i < meshes.size(); ++i) {
+		if (!mesh_cache_is_valid_arrays(meshes[i], true)) {
+			return Dictionary();
+		}
+	}
+
+	if (d.has("liquid") && !mesh_cache_is_valid_arrays(d["liquid"], false)) {
+		return Dictionary();
+	}
+
+	if (d.has("collider") && d["collider"].get_type() != Variant::POOL_VECTOR3_ARRAY) {
+		return Dictionary();
+	}
+
+	return d;
+}
+//surface arrays, steps can leave their mesh empty
+bool TerrainWorld::mesh_cache_is_valid_arrays(const Variant &arrays, const bool allow_empty) {
+	if (arrays.get_type() != Variant::ARRAY) {
+		return false;
+	}
+
+	Array arr = arrays;
+
+	if (arr.size() == 0) {
+		return allow_empty;
+	}
+
+	return arr.size() == VisualServer::ARRAY_MAX && arr[VisualServer::ARRAY_VERTEX].get_type() == Variant::POOL_VECTOR3_ARRAY;
+}
+void TerrainWorld::mesh_cache_store(const String &key, const Dictionary &entry) {
+	ERR_FAIL_COND(_mesh_cache_path == "");
+
+	String path = mesh_cache_get_file_path(key);
+
+	//chunks with the same data share an entry, so it's written to a file of its own first, then moved in place
+	String temp_path = path + "." + String::num_uint64(Thread::get_caller_id()) + ".tmp";
+
+#if VERSION_MAJOR < 4
+	DirAccess *da = DirAccess::create_for_path(_mesh_cache_path);
+
+	ERR_FAIL_COND(!da);
+
+	if (!da->dir_exists(_mesh_cache_path)) {
+		da->make_dir_recursive(_mesh_cache_path);
+	}
+
+	FileAccess *f = FileAccess::open(temp_path, FileAccess::WRITE);
+
+	if (!f) {
+		memdelete(da);
+		ERR_FAIL_MSG("Couldn't write mesh cache entry: " + temp_path);
+	}
+
+	f->store_var(entry);
+	memdelete(f);
+
+	if (da->rename(temp_path, path) != OK) {
+		da->remove(temp_path);
+	}
+
+	memdelete(da);
+#else
+	Ref<DirAccess> da = DirAccess::create_for_path(_mesh_cache_path);
+
+	ERR_FAIL_COND(da.is_null());
+
+	if (!da->dir_exists(_mesh_cache_path)) {
+		da->make_dir_recursive(_mesh_cache_path);
+	}
+
+	Ref<FileAccess> f = FileAccess::open(temp_path, FileAccess::WRITE);
+
+	ERR_FAIL_COND_MSG(f.is_null(), "Couldn't write mesh cache entry: " + temp_path);
+
+	f->store_var(entry);
+	f.unref();
+
+	if (da->rename(temp_path, path) != OK) {
+		da->remove(temp_path);
+	}
+#endif
+}
+void TerrainWorld::mesh_cache_clear() {
+	ERR_FAIL_COND(_mesh_cache_path == "");
+
+#if VERSION_MAJOR < 4
+	DirAccess *da = DirAccess::open(_mesh_cache_path);
+
+	if (!da) {
+		return;
+	}
+#else
+	Ref<DirAccess> da = DirAccess::open(_mesh_cache_path);
+
+	if (da.is_null()) {
+		return;
+	}
+#endif
+
+	da->list_dir_begin();
+
+	String file = da->get_next();
+
+	while (file != "") {
+		if (!da->current_is_dir() && (file.ends_with(".tmc") || file.ends_with(".tmp"))) {
+			da->remove(file);
+		}
+
+		file = da->get_next();
+	}
+
+	da->list_dir_end();
+
+#if VERSION_MAJOR < 4
+	memdelete(da);
+#endif
+}
+
+Ref<TerrainWorldArea> TerrainWorld::world_area_get(const int index) const {
+	ERR_FAIL_INDEX_V(index, _world_areas.size(), Ref<TerrainWorldArea>());
+
+	return _world_areas.get(index);
+}
+void TerrainWorld::world_area_add(const Ref<TerrainWorldArea> &area) {
+	_world_areas.push_back(area);
+}
+void TerrainWorld::world_area_remove(const int index) {
+	ERR_FAIL_INDEX(index, _world_areas.size());
+
+	_world_areas.VREMOVE(index);
+}
+void TerrainWorld::world_areas_clear() {
+	_world_areas.clear();
+}
+int TerrainWorld::world_area_get_count() const {
+	return _world_areas.size();
+}
+
+//Terra Structures
+
+Ref<TerrainStructure> TerrainWorld::voxel_structure_get(const int index) const {
+	ERR_FAIL_INDEX_V(index, _voxel_structures.size(), Ref<TerrainStructure>());
+
+	return _voxel_structures.get(index);
+}
+void TerrainWorld::voxel_structure_add(const Ref<TerrainStructure> &structure) {
+	_voxel_structures.push_back(structure);
+}
+void TerrainWorld::voxel_structure_remove(const Ref<TerrainStructure> &structure) {
+	if (!structure.is_valid())
+		return;
+
+	int index = _voxel_structures.find(structure);
+
+	if (index != -1)
+		_voxel_structures.VREMOVE(index);
+}
+void TerrainWorld::voxel_structure_remove_index(const int index) {
+	ERR_FAIL_INDEX(index, _voxel_structures.size());
+
+	_voxel_structures.VREMOVE(index);
+}
+void TerrainWorld::voxel_structures_clear() {
+	_voxel_structures.clear();
+}
+int TerrainWorld::voxel_structure_get_count() const {
+	return _voxel_structures.size();
+}
+void TerrainWorld::voxel_structure_add_at_position(Ref<TerrainStructure> structure, const Vector3 &world_position) {
+	ERR_FAIL_COND(!structure.is_valid());
+
+	structure->set_position_x(static_cast<int>(world_position.x / _voxel_scale));
+	structure->set_position_y(static_cast<int>(world_position.y / _voxel_scale));
+	structure->set_position_z(static_cast<int>(world_position.z / _voxel_scale));
+
+	voxel_structure_add(structure);
+}
+
+Vector<Variant> TerrainWorld::voxel_structures_get() {
+	VARIANT_ARRAY_GET(_voxel_structures);
+}
+void TerrainWorld::voxel_structures_set(const Vector<Variant> &structures) {
+	voxel_structures_clear();
+
+	for (int i = 0; i < structures.size(); ++i) {
+		Ref<TerrainLight> structure = Ref<TerrainLight>(structures[i]);
+
+		voxel_structure_add(structure);
+	}
+}
+
+void TerrainWorld::chunk_add(Ref<TerrainChunk> chunk, const int x, const int z) {
+	ERR_FAIL_COND(!chunk.is_valid());
+	ERR_FAIL_COND_MSG(chunk->get_voxel_world() != NULL && chunk->get_voxel_world() != this, "Chunk is already owned by an another world!");
+
+	IntPos pos(x, z);
+
+	//ERR_FAIL_COND(_chunks.has(pos));
+
+	chunk->set_voxel_world(this);
+	chunk->set_position(x, z);
+	chunk->world_transform_changed();
+
+	if (is_headless()) {
+		chunk->set_streaming_flags(chunk->get_streaming_flags() & ~TerrainChunk::STREAMING_FLAG_RENDER);
+	}
+
+	chunk_registry_add(chunk, pos);
+
+	if (is_inside_tree())
+		chunk->enter_tree();
+
+	if (has_method("_chunk_added")) {
+		CALL(_chunk_added, chunk);
+	}
+
+	emit_signal("chunk_added", chunk);
+}
+bool TerrainWorld::chunk_has(const int x, const int z) const {
+	return chunk_registry_get(x, z) != -1;
+}
+Ref<TerrainChunk> TerrainWorld::chunk_get(const int x, const int z) {
+	int index = chunk_registry_get(x, z);
+
+	if (index != -1)
+		return _chunks_vector[index];
+
+	return Ref<TerrainChunk>();
+}
+Ref<TerrainChunk> TerrainWorld::chunk_remove(const int x, const int z) {
+	int index = chunk_registry_get(x, z);
+
+	if (index == -1) {
+		return NULL;
+	}
+
+	return chunk_remove_index(index);
+}
+Ref<TerrainChunk> TerrainWorld::chunk_remove_index(const int index) {
+	ERR_FAIL_INDEX_V(index, _chunks_vector.size(), NULL);
+
+	Ref<TerrainChunk> chunk = _chunks_vector.get(index);
+
+	//keeps the rids on exit_tree
+	chunk->set_is_pooled(_use_chunk_pool && is_inside_tree());
+
+	chunk->exit_tree();
+
+	chunk_registry_remove(chunk);
+	generation_queue_remove(chunk);
+
+	if (chunk->get_is_generating()) {
+		chunk->cancel_build();
+	}
+
+	//never remove from this here
+	//_generating.erase(chunk);
+
+	emit_signal("chunk_removed", chunk);
+
+	//chunks that are still generating get added when they leave _generating
+	if (chunk->get_is_pooled() && !chunk->get_is_generating()) {
+		chunk_pool_add(chunk);
+	}
+
+	return chunk;
+}
+
+void TerrainWorld::chunk_active_sets_update(TerrainChunk *chunk) {
+	ERR_FAIL_COND(!chunk);
+
+	bool registered = chunk->get_voxel_world() == this && chunk->get_world_index() != -1;
+
+	chunk_active_set_toggle(chunk, CHUNK_ACTIVE_SET_PROCESS, registered && chunk->get_process());
+	chunk_active_set_toggle(chunk, CHUNK_ACTIVE_SET_PHYSICS_PROCESS, registered && chunk->get_physics_process());
+	chunk_active_set_toggle(chunk, CHUNK_ACTIVE_SET_GENERATING, registered && chunk->get_is_generating());
+}
+void TerrainWorld::chunk_active_sets_remove(TerrainChunk *chunk) {
+	ERR_FAIL_COND(!chunk);
+
+	for (int i = 0; i < CHUNK_ACTIVE_SET_MAX; ++i) {
+		chunk_active_set_toggle(chunk, i, false);
+	}
+}
+void TerrainWorld::chunk_active_sets_clear() {
+	for (int i = 0; i < CHUNK_ACTIVE_SET_MAX; ++i) {
+		for (int j = 0; j < _chunk_active_sets[i].size(); ++j) {
+			_chunk_active_sets[i][j]->set_active_set_index(i, -1);
+		}
+
+		_chunk_active_sets[i].clear();
+	}
+}
+int TerrainWorld::chunk_active_set_get_size(const int set) const {
+	ERR_FAIL_INDEX_V(set, CHUNK_ACTIVE_SET_MAX, 0);
+
+	return _chunk_active_sets[set].size();
+}
+void TerrainWorld::chunk_active_set_toggle(TerrainChunk *chunk, const int set, const bool active) {
+	int index = chunk->get_active_set_index(set);
+
+	if (active == (index != -1)) {
+		return;
+	}
+
+	Vector<TerrainChunk *> &chunks = _chunk_active_sets[set];
+
+	if (active) {
+		chunk->set_active_set_index(set, chunks.size());
+		chunks.push_back(chunk);
+		return;
+	}
+
+	ERR_FAIL_INDEX(index, chunks.size());
+	ERR_FAIL_COND(chunks[index] != chunk);
+
+	//swap remove
+	int last = chunks.size() - 1;
+
+	if (index != last) {
+		TerrainChunk *moved = chunks[last];
+
+		chunks.set(index, moved);
+		moved->set_active_set_index(set, index);
+	}
+
+	chunks.resize(last);
+	chunk->set_active_set_index(set, -1);
+}
+
+Ref<TerrainChunk> TerrainWorld::chunk_get_index(const int index) {
+	ERR_FAIL_INDEX_V(index, _chunks_vector.size(), NULL);
+
+	return _chunks_vector.get(index);
+}
+int TerrainWorld::chunk_get_count() const {
+	return _chunks_vector.size();
+}
+
+bool TerrainWorld::get_use_chunk_grid() const {
+	return _use_chunk_grid;
+}
+void TerrainWorld::set_use_chunk_grid(const bool value) {
+	_use_chunk_grid = value;
+
+	chunk_registry_rebuild();
+}
+
+Rect2 TerrainWorld::get_chunk_grid_bounds() const {
+	return Rect2(_chunk_grid_x, _chunk_grid_z, _chunk_grid_size_x, _chunk_grid_size_z);
+}
+void TerrainWorld::set_chunk_grid_bounds(const Rect2 &value) {
+	_chunk_grid_x = static_cast<int>(Math::floor(value.position.x));
+	_chunk_grid_z = static_cast<int>(Math::floor(value.position.y));
+	_chunk_grid_size_x = MAX(static_cast<int>(value.size.x), 0);
+	_chunk_grid_size_z = MAX(static_cast<int>(value.size.y), 0);
+
+	chunk_registry_rebuild();
+}
+
+void TerrainWorld::chunk_registry_add(const Ref<TerrainChunk> &chunk, const IntPos &pos) {
+	int index = chunk->get_world_index();
+
+	if (index < 0 || index >= _chunks_vector.size() || _chunks_vector[index] != chunk) {
+		index = _chunks_vector.size();
+
+		chunk->set_world_index(index);
+		_chunks_vector.push_back(chunk);
+	}
+
+	if (chunk_registry_get(pos.x, pos.z) == -1)
+		chunk_registry_set(pos, index);
+}
+void TerrainWorld::chunk_registry_remove(const Ref<TerrainChunk> &chunk) {
+	int index = chunk->get_world_index();
+
+	ERR_FAIL_INDEX(index, _chunks_vector.size());
+	ERR_FAIL_COND(_chunks_vector[index] != chunk);
+
+	IntPos pos(chunk->get_position_x(), chunk->get_position_z());
+
+	if (chunk_registry_get(pos.x, pos.z) == index) {
+		chunk_registry_set(pos, -1);
+	}
+
+	//swap remove, the last chunk takes this one's place
+	int last = _chunks_vector.size() - 1;
+
+	if (index != last) {
+		Ref<TerrainChunk> moved = _chunks_vector[last];
+
+		_chunks_vector.set(index, moved);
+		moved->set_world_index(index);
+
+		IntPos moved_pos(moved->get_position_x(), moved->get_position_z());
+
+		if (chunk_registry_get(moved_pos.x, moved_pos.z) == last) {
+			chunk_registry_set(moved_pos, index);
+		}
+	}
+
+	_chunks_vector.resize(last);
+	chunk->set_world_index(-1);
+}
+void TerrainWorld::chunk_registry_set(const IntPos &pos, const int index) {
+	if (_use_chunk_grid) {
+		int gx = pos.x - _chunk_grid_x;
+		int gz = pos.z - _chunk_grid_z;
+
+		if (gx >= 0 && gz >= 0 && gx < _chunk_grid_size_x && gz < _chunk_grid_size_z) {
+			_chunk_grid.ptrw()[gz * _chunk_grid_size_x + gx] = index;
+			return;
+		}
+	}
+
+	if (index == -1) {
+		_chunks.erase(pos);
+	} else {
+		_chunks.set(pos, index);
+	}
+}
+void TerrainWorld::chunk_registry_rebuild() {
+	_chunks.clear();
+	_chunk_grid.resize(0);
+
+	if (_use_chunk_grid) {
+		_chunk_grid.resize(_chunk_grid_size_x * _chunk_grid_size_z);
+
+		int *w = _chunk_grid.ptrw();
+
+		for (int i = 0; i < _chunk_grid.size(); ++i) {
+			w[i] = -1;
+		}
+	}
+
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		Ref<TerrainChunk> chunk = _chunks_vector[i];
+
+		ERR_CONTINUE(!chunk.is_valid());
+
+		if (chunk_registry_get(chunk->get_position_x(), chunk->get_position_z()) == -1) {
+			chunk_registry_set(IntPos(chunk->get_position_x(), chunk->get_position_z()), i);
+		}
+	}
+}
+
+void TerrainWorld::chunks_clear() {
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		Ref<TerrainChunk> chunk = _chunks_vector.get(i);
+
+		chunk->exit_tree();
+		chunk->set_world_index(-1);
+
+		emit_signal("chunk_removed", chunk);
+	}
+
+	_chunks_vector.clear();
+	_chunks.clear();
+	chunk_registry_rebuild();
+	_generation_queue.clear();
+
+	for (int i = 0; i < _generating.size(); ++i) {
+		Ref<TerrainChunk> chunk = _generating[i];
+
+		if (chunk->get_is_generating()) {
+			chunk->cancel_build();
+		}
+	}
+
+	//never remove from this here
+	//_generating.clear();
+}
+
+Ref<TerrainChunk> TerrainWorld::chunk_get_or_create(int x, int z) {
+	Ref<TerrainChunk> chunk = chunk_get(x, z);
+
+	if (!chunk.is_valid()) {
+		chunk = chunk_create(x, z);
+	}
+
+	return chunk;
+}
+
+Ref<TerrainChunk> TerrainWorld::chunk_create(const int x, const int z) {
+	Ref<TerrainChunk> c = chunk_pool_pop();
+	GET_CALLP(Ref<TerrainChunk>, c, _create_chunk, x, z, c);
+
+	generation_queue_add_to(c);
+
+	return c;
+}
+
+void TerrainWorld::chunk_setup(Ref<TerrainChunk> chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
 
 #if VERSION_MAJOR < 4
 	call("_create_chunk", chunk->get_position_x(), chunk->get_position_z(), chunk);
@@ -408,45 +1592,306 @@ void TerrainWorld::chunk_setup(Ref<TerrainChunk> chunk) {
 #endif
 }
 
+//Removed chunks are recycled (channels cleared, rids hidden, jobs reset) and handed out again by chunk_create(),
+//so streaming doesn't need to allocate new chunks, jobs, meshers and server objects all the time.
+void TerrainWorld::chunk_pool_add(const Ref<TerrainChunk> &chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+	ERR_FAIL_COND(chunk->is_in_tree());
+
+	if (!_use_chunk_pool || _chunk_pool.size() >= _chunk_pool_max_size || chunk->get_voxel_world() != this || chunk->get_world_index() != -1) {
+		chunk->set_is_pooled(false);
+		return;
+	}
+
+	chunk->recycle();
+
+	_chunk_pool.push_back(chunk);
+}
+Ref<TerrainChunk> TerrainWorld::chunk_pool_pop() {
+	if (_chunk_pool.size() == 0) {
+		return Ref<TerrainChunk>();
+	}
+
+	Ref<TerrainChunk> chunk = _chunk_pool[_chunk_pool.size() - 1];
+	_chunk_pool.resize(_chunk_pool.size() - 1);
+
+	chunk->set_is_pooled(false);
+
+	return chunk;
+}
+int TerrainWorld::chunk_pool_get_size() const {
+	return _chunk_pool.size();
+}
+void TerrainWorld::chunk_pool_clear() {
+	//the chunks free their rids when they get deleted
+	for (int i = 0; i < _chunk_pool.size(); ++i) {
+		Ref<TerrainChunk> chunk = _chunk_pool[i];
+
+		chunk->set_is_pooled(false);
+		chunk->set_voxel_world(NULL);
+	}
+
+	_chunk_pool.clear();
+}
+
+//The meshers set on jobs only hold settings, jobs borrow a mesher configured from them while they run, and return it
+//when they are done. This way the number of meshers (and their buffers) depend on the number of running jobs.
+//Can be called from any thread.
+Ref<TerrainMesher> TerrainWorld::mesher_pool_borrow(const Ref<TerrainMesher> &settings) {
+	ERR_FAIL_COND_V(!settings.is_valid(), settings);
+
+	//scripted meshers might keep state the settings can't describe
+	if (!_use_mesher_pool || settings->get_script_instance()) {
+		return settings;
+	}
+
+	StringName class_name = settings->get_class_name();
+	Ref<TerrainMesher> mesher;
+
+	_mesher_pool_mutex.lock();
+
+	for (int i = _mesher_pool.size() - 1; i >= 0; --i) {
+		if (_mesher_pool[i]->get_class_name() == class_name) {
+			mesher = _mesher_pool[i];
+			_mesher_pool.VREMOVE(i);
+			break;
+		}
+	}
+
+	_mesher_pool_mutex.unlock();
+
+	if (!mesher.is_valid()) {
+		mesher = Ref<TerrainMesher>(Object::cast_to<TerrainMesher>(ClassDB::INSTANCE(class_name)));
+
+		ERR_FAIL_COND_V(!mesher.is_valid(), settings);
+	}
+
+	mesher->copy_settings_from(settings);
+
+	return mesher;
+}
+void TerrainWorld::mesher_pool_return(const Ref<TerrainMesher> &mesher) {
+	ERR_FAIL_COND(!mesher.is_valid());
+
+	if (!_use_mesher_pool || mesher->get_script_instance()) {
+		return;
+	}
+
+	mesher->reset();
+	mesher->set_cancelled(false);
+	mesher->set_library(Ref<TerrainLibrary>());
+	mesher->set_material(Ref<Material>());
+
+	MutexLock lock(_mesher_pool_mutex);
+
+	_mesher_pool.push_back(mesher);
+}
+int TerrainWorld::mesher_pool_get_size() {
+	MutexLock lock(_mesher_pool_mutex);
+
+	return _mesher_pool.size();
+}
+void TerrainWorld::mesher_pool_clear() {
+	MutexLock lock(_mesher_pool_mutex);
+
+	_mesher_pool.clear();
+}
+
 Ref<TerrainChunk> TerrainWorld::_create_chunk(const int x, const int z, Ref<TerrainChunk> chunk) {
 	if (!chunk.is_valid()) {
 		chunk.INSTANCE();
 	}
 
-	//no meshers here
+	//no meshers here
+
+	ERR_FAIL_COND_V(!chunk.is_valid(), NULL);
+
+	chunk->set_name("Chunk[" + String::num(x) + "," + String::num(z) + "]");
+
+	chunk->set_voxel_world(this);
+
+	chunk->set_position(x, z);
+	chunk->set_world_height(_world_height);
+	chunk->set_library(_library);
+	chunk->set_voxel_scale(_voxel_scale);
+	chunk->set_palette_channels(_palette_channels);
+	chunk->set_size(_chunk_size_x, _chunk_size_z, _data_margin_start, _data_margin_end);
+	//chunk->set_translation(Vector3(x * _chunk_size_x * _voxel_scale, y * _chunk_size_y * _voxel_scale, z * _chunk_size_z * _voxel_scale));
+
+	if (!get_active()) {
+		chunk->set_visible(false);
+	}
+
+	chunk_add(chunk, x, z);
+
+	return chunk;
+}
+
+void TerrainWorld::chunk_generate(Ref<TerrainChunk> chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+
+	if (chunk_has_generate_job(chunk)) {
+		//TerrainGenerateJob will call chunk_generate_data()
+		chunk->set_is_generation_pending(true);
+	} else {
+		chunk_generate_data(chunk);
+		chunk->set_is_generation_pending(false);
+	}
+
+	chunk->build();
+}
+
+void TerrainWorld::chunk_generate_data(Ref<TerrainChunk> chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+
+	if (has_method("_prepare_chunk_for_generation")) {
+		CALL(_prepare_chunk_for_generation, chunk);
+	}
+
+	CALL(_generate_chunk, chunk);
+
+	//channels the generator filled with one value don't need a buffer
+	chunk->channels_compact();
+}
+
+bool TerrainWorld::chunk_has_generate_job(const Ref<TerrainChunk> &chunk) const {
+	ERR_FAIL_COND_V(!chunk.is_valid(), false);
+
+	for (int i = 0; i < chunk->job_get_count(); ++i) {
+		Ref<TerrainGenerateJob> j = chunk->job_get(i);
+
+		if (j.is_valid()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TerrainWorld::is_generation_thread_safe() const {
+	//scripts can only run on the main thread
+	ScriptInstance *si = get_script_instance();
+
+	if (si && (si->has_method("_prepare_chunk_for_generation") || si->has_method("_generate_chunk"))) {
+		return false;
+	}
+
+	if (_level_generator.is_valid() && !_level_generator->is_thread_safe()) {
+		return false;
+	}
+
+	for (int i = 0; i < _voxel_structures.size(); ++i) {
+		Ref<TerrainStructure> structure = _voxel_structures.get(i);
+
+		if (structure.is_valid() && !structure->is_thread_safe()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Offline generation, e.g. from a tool script, or from the command line with a headless build.
+//Only works while the world is outside of the tree, so nothing gets queued, meshed or streamed.
+//Chunks that already exist are left alone, so a saved world can be extended later.
+struct TerrainWorld::PregenerateData {
+	TerrainWorld *world;
+	Vector<Ref<TerrainChunk>> chunks;
+	SafeNumeric<uint32_t> next;
+	bool generate;
+};
+
+void TerrainWorld::_pregenerate_thread_func(void *p_user_data) {
+	PregenerateData *data = reinterpret_cast<PregenerateData *>(p_user_data);
+
+	while (true) {
+		uint32_t index = data->next.postincrement();
+
+		if (index >= static_cast<uint32_t>(data->chunks.size())) {
+			return;
+		}
+
+		Ref<TerrainChunk> chunk = data->chunks[index];
+
+		if (data->generate) {
+			data->world->chunk_generate_data(chunk);
+		}
+
+		data->world->_pregenerate_chunk_lighting(chunk);
+	}
+}
+
+Error TerrainWorld::pregenerate(const Rect2 &chunk_rect, const String &save_path, const int thread_count) {
+	ERR_FAIL_COND_V_MSG(is_inside_tree(), ERR_UNAVAILABLE, "Only worlds outside of the scene tree can be pregenerated!");
 
-	ERR_FAIL_COND_V(!chunk.is_valid(), NULL);
+	int start_x = static_cast<int>(Math::floor(chunk_rect.position.x));
+	int start_z = static_cast<int>(Math::floor(chunk_rect.position.y));
+	int end_x = start_x + static_cast<int>(Math::ceil(chunk_rect.size.x));
+	int end_z = start_z + static_cast<int>(Math::ceil(chunk_rect.size.y));
 
-	chunk->set_name("Chunk[" + String::num(x) + "," + String::num(z) + "]");
+	PregenerateData data;
+	data.world = this;
+	data.generate = is_generation_thread_safe();
 
-	chunk->set_voxel_world(this);
+	for (int z = start_z; z < end_z; ++z) {
+		for (int x = start_x; x < end_x; ++x) {
+			if (chunk_has(x, z)) {
+				continue;
+			}
 
-	chunk->set_position(x, z);
-	chunk->set_world_height(_world_height);
-	chunk->set_library(_library);
-	chunk->set_voxel_scale(_voxel_scale);
-	chunk->set_size(_chunk_size_x, _chunk_size_z, _data_margin_start, _data_margin_end);
-	//chunk->set_translation(Vector3(x * _chunk_size_x * _voxel_scale, y * _chunk_size_y * _voxel_scale, z * _chunk_size_z * _voxel_scale));
+			Ref<TerrainChunk> c = chunk_pool_pop();
+			GET_CALLP(Ref<TerrainChunk>, c, _create_chunk, x, z, c);
 
-	if (!get_active()) {
-		chunk->set_visible(false);
+			ERR_CONTINUE(!c.is_valid());
+
+			//scripted generators can only run on this thread
+			if (!data.generate) {
+				chunk_generate_data(c);
+			}
+
+			data.chunks.push_back(c);
+		}
 	}
 
-	chunk_add(chunk, x, z);
+	int count = thread_count;
 
-	return chunk;
-}
+	if (count <= 0) {
+		count = OS::get_singleton()->get_processor_count();
+	}
 
-void TerrainWorld::chunk_generate(Ref<TerrainChunk> chunk) {
-	ERR_FAIL_COND(!chunk.is_valid());
+	count = CLAMP(count, 1, MAX(data.chunks.size(), 1));
 
-	if (has_method("_prepare_chunk_for_generation")) {
-		CALL(_prepare_chunk_for_generation, chunk);
+	//the calling thread works too
+	Vector<Thread *> threads;
+
+	for (int i = 0; i < count - 1; ++i) {
+		Thread *thread = memnew(Thread);
+		thread->start(_pregenerate_thread_func, &data);
+		threads.push_back(thread);
 	}
 
-	CALL(_generate_chunk, chunk);
+	_pregenerate_thread_func(&data);
 
-	chunk->build();
+	for (int i = 0; i < threads.size(); ++i) {
+		threads[i]->wait_to_finish();
+		memdelete(threads[i]);
+	}
+
+	if (save_path == "") {
+		return OK;
+	}
+
+	Ref<PackedScene> scene;
+	scene.INSTANCE();
+
+	Error err = scene->pack(this);
+	ERR_FAIL_COND_V(err != OK, err);
+
+#if VERSION_MAJOR < 4
+	return ResourceSaver::save(save_path, scene);
+#else
+	return ResourceSaver::save(scene, save_path);
+#endif
 }
 
 Vector<Variant> TerrainWorld::chunks_get() {
@@ -460,7 +1905,7 @@ void TerrainWorld::chunks_set(const Vector<Variant> &chunks) {
 
 			if (chunks.find(chunk) == -1) {
 				chunk_remove_index(i);
-				_generation_queue.erase(chunk);
+				generation_queue_remove(chunk);
 
 				chunk->exit_tree();
 
@@ -482,18 +1927,25 @@ void TerrainWorld::chunks_set(const Vector<Variant> &chunks) {
 			if (!chunk.is_valid())
 				continue;
 
-			if (_chunks_vector.find(chunk) != -1)
+			int index = chunk->get_world_index();
+
+			if (index >= 0 && index < _chunks_vector.size() && _chunks_vector[index] == chunk)
 				continue;
 
 			chunk_add(chunk, chunk->get_position_x(), chunk->get_position_z());
 		}
 	} else {
 		_chunks_vector.clear();
+		chunk_registry_rebuild();
 
 		for (int i = 0; i < chunks.size(); ++i) {
 			Ref<TerrainChunk> chunk = Ref<TerrainChunk>(chunks[i]);
 
-			_chunks_vector.push_back(chunk);
+			if (!chunk.is_valid())
+				continue;
+
+			chunk->set_world_index(-1);
+			chunk_registry_add(chunk, IntPos(chunk->get_position_x(), chunk->get_position_z()));
 		}
 	}
 }
@@ -530,16 +1982,65 @@ bool TerrainWorld::can_chunk_do_build_step() {
 	return _num_frame_chunk_build_steps++ < _max_frame_chunk_build_steps;
 }
 
+//step is an id for a job class + phase pair, see TerrainJob::get_build_step_id()
+bool TerrainWorld::build_step_begin(const int step, const bool physics) {
+	int budget = physics ? _physics_process_build_budget_usec : _process_build_budget_usec;
+	uint64_t used = physics ? _physics_frame_build_used_usec : _frame_build_used_usec;
+
+	if (budget > 0 && used > 0) {
+		//the first step of a frame always runs, so steps that are more expensive than the whole budget can't starve
+		//steps without an estimate yet only run while there is budget left
+		const float *cost = _build_step_costs.getptr(step);
+		uint64_t estimate = cost ? static_cast<uint64_t>(*cost) : 0;
+
+		if (used >= static_cast<uint64_t>(budget) || used + estimate > static_cast<uint64_t>(budget)) {
+			return false;
+		}
+	}
+
+	return can_chunk_do_build_step();
+}
+
+void TerrainWorld::build_step_end(const int step, const bool physics, const int usec) {
+	if (physics) {
+		_physics_frame_build_used_usec += usec;
+	} else {
+		_frame_build_used_usec += usec;
+	}
+
+	float *cost = _build_step_costs.getptr(step);
+
+	if (cost) {
+		*cost += (usec - *cost) * _build_step_cost_smoothing;
+	} else {
+		_build_step_costs.set(step, usec);
+	}
+}
+
+float TerrainWorld::build_step_get_cost_estimate(const int step) const {
+	const float *cost = _build_step_costs.getptr(step);
+
+	if (!cost) {
+		return 0;
+	}
+
+	return *cost;
+}
+
+int TerrainWorld::build_step_get_frame_used_usec(const bool physics) const {
+	return static_cast<int>(physics ? _physics_frame_build_used_usec : _frame_build_used_usec);
+}
+
 bool TerrainWorld::is_position_walkable(const Vector3 &p_pos) {
 	int x = static_cast<int>(Math::floor(p_pos.x / (_chunk_size_x * _voxel_scale)));
 	int z = static_cast<int>(Math::floor(p_pos.z / (_chunk_size_z * _voxel_scale)));
 
-	Ref<TerrainChunk> c = chunk_get(x, z);
+	int index = chunk_registry_get(x, z);
 
-	if (!c.is_valid())
+	if (index == -1)
 		return false;
 
-	return !c->get_is_generating();
+	return !_chunks_vector[index]->get_is_generating();
 }
 
 void TerrainWorld::on_chunk_mesh_generation_finished(Ref<TerrainChunk> p_chunk) {
@@ -551,26 +2052,181 @@ void TerrainWorld::generation_queue_add_to(const Ref<TerrainChunk> &chunk) {
 
 	set_process_internal(true);
 
-	_generation_queue.push_back(chunk);
+	chunk->set_is_generation_pending(true);
+
+	GenerationQueueEntry e;
+	e.chunk = chunk;
+	e.priority = generation_queue_get_priority(chunk);
+	e.order = _generation_queue_order++;
+
+	_generation_queue.push_back(e);
+	generation_queue_sift_up(_generation_queue.size() - 1);
 }
 Ref<TerrainChunk> TerrainWorld::generation_queue_get_index(int index) {
 	ERR_FAIL_INDEX_V(index, _generation_queue.size(), NULL);
 
-	return _generation_queue.get(index);
+	return _generation_queue[index].chunk;
 }
 void TerrainWorld::generation_queue_remove_index(int index) {
 	ERR_FAIL_INDEX(index, _generation_queue.size());
 
-	_generation_queue.VREMOVE(index);
+	int last = _generation_queue.size() - 1;
+
+	if (index != last) {
+		_generation_queue.set(index, _generation_queue[last]);
+	}
+
+	_generation_queue.resize(last);
+
+	if (index < last) {
+		generation_queue_sift_down(index);
+		generation_queue_sift_up(index);
+	}
+}
+void TerrainWorld::generation_queue_remove(const Ref<TerrainChunk> &chunk) {
+	//only queued chunks are pending
+	if (!chunk.is_valid() || !chunk->get_is_generation_pending()) {
+		return;
+	}
+
+	for (int i = 0; i < _generation_queue.size(); ++i) {
+		if (_generation_queue[i].chunk == chunk) {
+			generation_queue_remove_index(i);
+			return;
+		}
+	}
 }
 int TerrainWorld::generation_queue_get_size() const {
 	return _generation_queue.size();
 }
+Ref<TerrainChunk> TerrainWorld::generation_queue_pop() {
+	while (_generation_queue.size() > 0) {
+		GenerationQueueEntry e = _generation_queue[0];
+
+		generation_queue_remove_index(0);
+
+		//priorities are only recalculated lazily, when they reach the top
+		float p = generation_queue_get_priority(e.chunk);
+
+		if (_generation_queue.size() == 0 || p <= _generation_queue[0].priority || p <= e.priority) {
+			return e.chunk;
+		}
+
+		e.priority = p;
+		_generation_queue.push_back(e);
+		generation_queue_sift_up(_generation_queue.size() - 1);
+	}
+
+	return Ref<TerrainChunk>();
+}
+float TerrainWorld::generation_queue_get_priority(const Ref<TerrainChunk> &chunk) const {
+	if (!_generation_has_viewer || !chunk.is_valid()) {
+		return 0;
+	}
+
+	Vector2 d = Vector2(chunk->get_position_x() + 0.5, chunk->get_position_z() + 0.5) - _generation_viewer_position;
+	float l = d.length();
+
+	if (l < 1) {
+		return l;
+	}
+
+	//0 in front of the viewer, 1 behind it
+	float behind = (1.0 - (d / l).dot(_generation_viewer_heading)) * 0.5;
+
+	return l * (1.0 + _generation_heading_bias * behind);
+}
+void TerrainWorld::generation_queue_update_viewer() {
+	if (!_player || !INSTANCE_VALIDATE(_player)) {
+		_generation_has_viewer = false;
+
+		return;
+	}
+
+	Transform t = get_global_transform().affine_inverse() * _player->get_global_transform();
+
+	_generation_viewer_position = Vector2(t.origin.x / (_chunk_size_x * _voxel_scale), t.origin.z / (_chunk_size_z * _voxel_scale));
+
+	Vector3 forward = -t.basis.get_axis(2);
+	Vector2 heading = Vector2(forward.x, forward.z);
+
+	if (heading.length_squared() > CMP_EPSILON) {
+		_generation_viewer_heading = heading.normalized();
+	}
+
+	if (!_generation_has_viewer) {
+		_generation_has_viewer = true;
+		generation_queue_reprioritize();
+		return;
+	}
+
+	//small moves are handled lazily in generation_queue_pop(), teleports and turning around need a full update
+	if (_generation_viewer_position.distance_to(_generation_queue_position) >= _generation_reprioritize_distance ||
+			_generation_viewer_heading.dot(_generation_queue_heading) < 0) {
+		generation_queue_reprioritize();
+	}
+}
+void TerrainWorld::generation_queue_reprioritize() {
+	_generation_queue_position = _generation_viewer_position;
+	_generation_queue_heading = _generation_viewer_heading;
+
+	GenerationQueueEntry *w = _generation_queue.ptrw();
+	int size = _generation_queue.size();
+
+	for (int i = 0; i < size; ++i) {
+		w[i].priority = generation_queue_get_priority(w[i].chunk);
+	}
+
+	for (int i = size / 2 - 1; i >= 0; --i) {
+		generation_queue_sift_down(i);
+	}
+}
+
+void TerrainWorld::generation_queue_sift_up(int index) {
+	GenerationQueueEntry *w = _generation_queue.ptrw();
+
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+
+		if (!(w[index] < w[parent])) {
+			break;
+		}
+
+		SWAP(w[index], w[parent]);
+		index = parent;
+	}
+}
+void TerrainWorld::generation_queue_sift_down(int index) {
+	GenerationQueueEntry *w = _generation_queue.ptrw();
+	int size = _generation_queue.size();
+
+	while (true) {
+		int l = index * 2 + 1;
+		int r = l + 1;
+		int smallest = index;
+
+		if (l < size && w[l] < w[smallest]) {
+			smallest = l;
+		}
+
+		if (r < size && w[r] < w[smallest]) {
+			smallest = r;
+		}
+
+		if (smallest == index) {
+			break;
+		}
+
+		SWAP(w[index], w[smallest]);
+		index = smallest;
+	}
+}
 
 void TerrainWorld::generation_add_to(const Ref<TerrainChunk> &chunk) {
 	ERR_FAIL_COND(!chunk.is_valid());
 
 	_generating.push_back(chunk);
+	_generating_start_usec.push_back(OS::get_singleton()->get_ticks_usec());
 }
 Ref<TerrainChunk> TerrainWorld::generation_get_index(const int index) {
 	ERR_FAIL_INDEX_V(index, _generating.size(), NULL);
@@ -581,11 +2237,95 @@ void TerrainWorld::generation_remove_index(const int index) {
 	ERR_FAIL_INDEX(index, _generating.size());
 
 	_generating.VREMOVE(index);
+	_generating_start_usec.VREMOVE(index);
 }
 int TerrainWorld::generation_get_size() const {
 	return _generating.size();
 }
 
+//the built in pool is only used when the thread_pool module is not present
+void TerrainWorld::worker_pool_start() {
+#if !THREAD_POOL_PRESENT
+	if (!_use_worker_threads || _worker_pool->is_running()) {
+		return;
+	}
+
+	int count = _worker_thread_count;
+
+	if (count == 0) {
+		count = MAX(OS::get_singleton()->get_processor_count() - 1, 1);
+	}
+
+	_worker_pool->start(count);
+#endif
+}
+void TerrainWorld::worker_pool_stop() {
+	_worker_pool->stop();
+}
+bool TerrainWorld::worker_pool_is_running() const {
+	return _worker_pool->is_running();
+}
+void TerrainWorld::worker_pool_add_job(const Ref<TerrainJob> &job) {
+	_worker_pool->add_job(job);
+}
+bool TerrainWorld::worker_pool_has_job(const Ref<TerrainJob> &job) {
+	return _worker_pool->has_job(job);
+}
+bool TerrainWorld::worker_pool_cancel_job(const Ref<TerrainJob> &job) {
+	return _worker_pool->cancel_job(job);
+}
+
+//additive increase, multiplicative decrease on the concurrent generation count,
+//grows while there is a backlog and chunks finish within the target latency
+void TerrainWorld::generation_adapt(const float delta) {
+	_adaptive_generations_timer += delta;
+
+	if (_adaptive_generations_timer < _adaptive_generations_interval) {
+		return;
+	}
+
+	_adaptive_generations_timer = 0;
+
+	int workers = get_generation_worker_count();
+	int upper = _adaptive_generations_max > 0 ? _adaptive_generations_max : workers;
+	int lower = MIN(_adaptive_generations_min, upper);
+	int current = CLAMP(_max_concurrent_generations, lower, upper);
+	int queued = _generation_queue.size();
+
+	//chunks that are still in flight count too, otherwise a stall would look like a fast pipeline
+	float latency = _generation_latency;
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < _generating_start_usec.size(); ++i) {
+		latency = MAX(latency, (now - _generating_start_usec[i]) / 1000000.0);
+	}
+
+	String reason;
+
+	if (latency > _adaptive_generations_target_latency * 1.5 && current > lower) {
+		current = MAX(current * 3 / 4, lower);
+		reason = "latency above target";
+	} else if (queued == 0) {
+		reason = "queue empty";
+	} else if (current >= upper) {
+		reason = "at upper bound";
+	} else if (latency <= _adaptive_generations_target_latency) {
+		++current;
+		reason = "queue backlog";
+	} else {
+		reason = "latency near target";
+	}
+
+	_adaptive_generations_reason = reason + " (queue: " + itos(queued) + ", latency: " + rtos(latency * 1000.0) + " ms, completed: " + itos(_generation_completed) + ", workers: " + itos(workers) + ")";
+	_generation_completed = 0;
+
+	if (current != _max_concurrent_generations) {
+		print_verbose("TerrainWorld: max_concurrent_generations " + itos(_max_concurrent_generations) + " -> " + itos(current) + ", " + _adaptive_generations_reason);
+
+		_max_concurrent_generations = current;
+	}
+}
+
 #if PROPS_PRESENT
 void TerrainWorld::prop_add(Transform transform, const Ref<PropData> &prop, const bool apply_voxel_scale) {
 	ERR_FAIL_COND(!prop.is_valid());
@@ -766,10 +2506,10 @@ uint8_t TerrainWorld::get_voxel_at_world_position(const Vector3 &world_position,
 		bz += get_chunk_size_z();
 	}
 
-	Ref<TerrainChunk> chunk = chunk_get(x, z);
+	int index = chunk_registry_get(x, z);
 
-	if (chunk.is_valid())
-		return chunk->get_voxel(bx, bz, channel_index);
+	if (index != -1)
+		return _chunks_vector[index]->get_voxel(bx, bz, channel_index);
 
 	return 0;
 }
@@ -890,22 +2630,93 @@ TerrainWorld::TerrainWorld() {
 	_is_priority_generation = true;
 	_max_concurrent_generations = 3;
 
+	_use_chunk_grid = false;
+	_chunk_grid_x = 0;
+	_chunk_grid_z = 0;
+	_chunk_grid_size_x = 0;
+	_chunk_grid_size_z = 0;
+
+	_generation_queue_order = 0;
+	_generation_heading_bias = 1;
+	_generation_reprioritize_distance = 4;
+	_generation_has_viewer = false;
+
+	_adaptive_generations = false;
+	_adaptive_generations_min = 1;
+	_adaptive_generations_max = 0;
+	_adaptive_generations_target_latency = 0.5;
+	_adaptive_generations_interval = 0.5;
+	_adaptive_generations_timer = 0;
+	_generation_latency = 0;
+	_generation_completed = 0;
+
 	_chunk_size_x = 16;
 	_chunk_size_z = 16;
 	_current_seed = 0;
 	_data_margin_start = 0;
 	_data_margin_end = 0;
 	_world_height = 256;
+	_palette_channels = 0;
 
 	_voxel_scale = 1;
-	_chunk_spawn_range = 4;
 
 	_player = NULL;
+
+	_streaming = false;
+	_streaming_dirty = true;
+	_streaming_has_center = false;
+	_streaming_despawn_margin = 1;
+	_streaming_offsets_range = -1;
+
+	_collider_lod_range = 0;
+	_collider_anchor_range = 1;
+	_collider_anchors_dirty = false;
+
+	_collider_region_size = 0;
+
+	_mesh_cache_path = "";
+
+	_headless_mode = HEADLESS_MODE_AUTO;
+
+	_use_mesher_pool = true;
+
+	_use_chunk_pool = false;
+	_chunk_pool_max_size = 64;
+
+	_use_worker_threads = true;
+	_worker_thread_count = 0;
+	_worker_pool = memnew(TerrainWorkerPool);
+
+	_streaming_rings[STREAMING_RING_DATA].range = 6;
+	_streaming_rings[STREAMING_RING_DATA].spawn_budget = 4;
+	_streaming_rings[STREAMING_RING_DATA].despawn_budget = 8;
+
+	_streaming_rings[STREAMING_RING_COLLIDER].range = 2;
+	_streaming_rings[STREAMING_RING_COLLIDER].spawn_budget = 2;
+	_streaming_rings[STREAMING_RING_COLLIDER].despawn_budget = 8;
+
+	_streaming_rings[STREAMING_RING_RENDER].range = 4;
+	_streaming_rings[STREAMING_RING_RENDER].spawn_budget = 2;
+	_streaming_rings[STREAMING_RING_RENDER].despawn_budget = 8;
 	_max_frame_chunk_build_steps = 0;
 	_num_frame_chunk_build_steps = 0;
+	_process_build_budget_usec = 0;
+	_physics_process_build_budget_usec = 0;
+	_build_step_cost_smoothing = 0.2;
+	_frame_build_used_usec = 0;
+	_physics_frame_build_used_usec = 0;
 }
 
 TerrainWorld ::~TerrainWorld() {
+	worker_pool_stop();
+	memdelete(_worker_pool);
+	_worker_pool = NULL;
+
+	chunk_pool_clear();
+	mesher_pool_clear();
+	collider_regions_clear();
+	chunk_active_sets_clear();
+
 	_chunks.clear();
 	_chunks_vector.clear();
 	_world_areas.clear();
@@ -918,6 +2729,7 @@ TerrainWorld ::~TerrainWorld() {
 
 	_generation_queue.clear();
 	_generating.clear();
+	_generating_start_usec.clear();
 
 	_lights.clear();
 }
@@ -943,6 +2755,10 @@ void TerrainWorld::_generate_chunk(Ref<TerrainChunk> chunk) {
 	}
 }
 
+void TerrainWorld::_pregenerate_chunk_lighting(Ref<TerrainChunk> chunk) {
+	//the base world has no lighting data
+}
+
 void TerrainWorld::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_ENTER_TREE: {
@@ -952,7 +2768,10 @@ void TerrainWorld::_notification(int p_what) {
 			set_physics_process_internal(true);
 			set_notify_transform(true);
 
-			if (_library.is_valid())
+			worker_pool_start();
+
+			//atlases and materials are only needed for meshes
+			if (_library.is_valid() && !is_headless())
 				_library->refresh_rects();
 
 			for (int i = 0; i < _chunks_vector.size(); ++i) {
@@ -968,19 +2787,35 @@ void TerrainWorld::_notification(int p_what) {
 		}
 		case NOTIFICATION_INTERNAL_PROCESS: {
 			_num_frame_chunk_build_steps = 0;
+			_frame_build_used_usec = 0;
 
-			for (int i = 0; i < _chunks_vector.size(); ++i) {
-				Ref<TerrainChunk> chunk = _chunks_vector[i];
+			if (_worker_pool->is_running()) {
+				_worker_pool->process_completed();
+			}
 
-				ERR_CONTINUE(!chunk.is_valid());
+			if (_streaming && !Engine::get_singleton()->is_editor_hint()) {
+				streaming_update();
+			}
 
-				if (chunk->get_process()) {
-					chunk->process(get_process_delta_time());
+			//backwards, so chunks can leave the sets while they are iterated
+			for (int i = _chunk_active_sets[CHUNK_ACTIVE_SET_PROCESS].size() - 1; i >= 0; --i) {
+				if (i >= _chunk_active_sets[CHUNK_ACTIVE_SET_PROCESS].size()) {
+					continue;
 				}
 
-				if (chunk->get_is_generating()) {
-					chunk->generation_process(get_process_delta_time());
+				Ref<TerrainChunk> chunk = Ref<TerrainChunk>(_chunk_active_sets[CHUNK_ACTIVE_SET_PROCESS][i]);
+
+				chunk->process(get_process_delta_time());
+			}
+
+			for (int i = _chunk_active_sets[CHUNK_ACTIVE_SET_GENERATING].size() - 1; i >= 0; --i) {
+				if (i >= _chunk_active_sets[CHUNK_ACTIVE_SET_GENERATING].size()) {
+					continue;
 				}
+
+				Ref<TerrainChunk> chunk = Ref<TerrainChunk>(_chunk_active_sets[CHUNK_ACTIVE_SET_GENERATING][i]);
+
+				chunk->generation_process(get_process_delta_time());
 			}
 
 #if VERSION_MAJOR > 3
@@ -1001,59 +2836,94 @@ void TerrainWorld::_notification(int p_what) {
 				Ref<TerrainChunk> chunk = _generating.get(i);
 
 				if (!chunk.is_valid()) {
-					_generating.VREMOVE(i);
+					generation_remove_index(i);
 					--i;
 					continue;
 				}
 
-				if (!chunk->get_is_generating()) {
-					_generating.VREMOVE(i);
+				//cancelled builds hand their jobs back, they don't count towards the latency
+				if (chunk->is_build_aborted() && (!chunk->get_is_generating() || chunk->is_safe_to_delete())) {
+					generation_remove_index(i);
 					--i;
+
+					if (chunk->get_is_pooled()) {
+						chunk_pool_add(chunk);
+					}
+
 					continue;
 				}
 
-				if (chunk->is_build_aborted() && chunk->is_safe_to_delete()) {
-					_generating.VREMOVE(i);
+				if (!chunk->get_is_generating()) {
+					float latency = (OS::get_singleton()->get_ticks_usec() - _generating_start_usec[i]) / 1000000.0;
+
+					_generation_latency = _generation_latency == 0 ? latency : Math::lerp(_generation_latency, latency, 0.2f);
+					++_generation_completed;
+
+					generation_remove_index(i);
 					--i;
 					continue;
 				}
 			}
 
+			if (_adaptive_generations) {
+				generation_adapt(get_process_delta_time());
+			}
+
 			if (_generating.size() >= _max_concurrent_generations)
 				return;
 
 			if (_generation_queue.size() == 0)
 				return;
 
+			generation_queue_update_viewer();
+
 			while (_generating.size() < _max_concurrent_generations && _generation_queue.size() != 0) {
-				Ref<TerrainChunk> chunk = _generation_queue.get(0);
-				_generation_queue.VREMOVE(0);
+				Ref<TerrainChunk> chunk = generation_queue_pop();
 
 				ERR_FAIL_COND(!chunk.is_valid());
 
-				_generating.push_back(chunk);
+				generation_add_to(chunk);
 
 				chunk_generate(chunk);
 			}
 			break;
 		}
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
-			for (int i = 0; i < _chunks_vector.size(); ++i) {
-				Ref<TerrainChunk> chunk = _chunks_vector[i];
-
-				ERR_CONTINUE(!chunk.is_valid());
+			_physics_frame_build_used_usec = 0;
 
-				if (chunk->get_process()) {
-					chunk->physics_process(get_physics_process_delta_time());
+			for (int i = _chunk_active_sets[CHUNK_ACTIVE_SET_PHYSICS_PROCESS].size() - 1; i >= 0; --i) {
+				if (i >= _chunk_active_sets[CHUNK_ACTIVE_SET_PHYSICS_PROCESS].size()) {
+					continue;
 				}
 
-				if (chunk->get_is_generating()) {
-					chunk->generation_physics_process(get_physics_process_delta_time());
+				Ref<TerrainChunk> chunk = Ref<TerrainChunk>(_chunk_active_sets[CHUNK_ACTIVE_SET_PHYSICS_PROCESS][i]);
+
+				chunk->physics_process(get_physics_process_delta_time());
+			}
+
+			for (int i = _chunk_active_sets[CHUNK_ACTIVE_SET_GENERATING].size() - 1; i >= 0; --i) {
+				if (i >= _chunk_active_sets[CHUNK_ACTIVE_SET_GENERATING].size()) {
+					continue;
 				}
+
+				Ref<TerrainChunk> chunk = Ref<TerrainChunk>(_chunk_active_sets[CHUNK_ACTIVE_SET_GENERATING][i]);
+
+				chunk->generation_physics_process(get_physics_process_delta_time());
 			}
 			break;
 		}
 		case NOTIFICATION_EXIT_TREE: {
+			//the workers have to be joined before the chunks lose their world, queued jobs get cancelled first so stopping doesn't run them
+			for (int i = 0; i < _chunks_vector.size(); ++i) {
+				Ref<TerrainChunk> chunk = _chunks_vector[i];
+
+				if (chunk.is_valid() && chunk->get_voxel_world() == this) {
+					chunk->cancel_build();
+				}
+			}
+
+			worker_pool_stop();
+
 			for (int i = 0; i < _chunks_vector.size(); ++i) {
 				Ref<TerrainChunk> chunk = _chunks_vector[i];
 
@@ -1064,6 +2934,9 @@ void TerrainWorld::_notification(int p_what) {
 					}
 				}
 			}
+
+			chunk_pool_clear();
+			collider_regions_clear();
 			break;
 		}
 		case NOTIFICATION_TRANSFORM_CHANGED: {
@@ -1074,6 +2947,11 @@ void TerrainWorld::_notification(int p_what) {
 					chunk->world_transform_changed();
 				}
 			}
+
+			//chunk shapes are relative to the world in region bodies
+			for (int i = 0; i < _collider_regions.size(); ++i) {
+				PhysicsServer::get_singleton()->body_set_state(_collider_regions[i].body, PhysicsServer::BODY_STATE_TRANSFORM, get_transform());
+			}
 			break;
 		}
 	}
@@ -1112,10 +2990,92 @@ void TerrainWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_world_height", "height"), &TerrainWorld::set_world_height);
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "world_height"), "set_world_height", "get_world_height");
 
+	ClassDB::bind_method(D_METHOD("get_palette_channels"), &TerrainWorld::get_palette_channels);
+	ClassDB::bind_method(D_METHOD("set_palette_channels", "value"), &TerrainWorld::set_palette_channels);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "palette_channels"), "set_palette_channels", "get_palette_channels");
+
 	ClassDB::bind_method(D_METHOD("get_max_concurrent_generations"), &TerrainWorld::get_max_concurrent_generations);
 	ClassDB::bind_method(D_METHOD("set_max_concurrent_generations", "height"), &TerrainWorld::set_max_concurrent_generations);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_concurrent_generations"), "set_max_concurrent_generations", "get_max_concurrent_generations");
 
+	ClassDB::bind_method(D_METHOD("get_generation_heading_bias"), &TerrainWorld::get_generation_heading_bias);
+	ClassDB::bind_method(D_METHOD("set_generation_heading_bias", "value"), &TerrainWorld::set_generation_heading_bias);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "generation_heading_bias"), "set_generation_heading_bias", "get_generation_heading_bias");
+
+	ClassDB::bind_method(D_METHOD("get_generation_reprioritize_distance"), &TerrainWorld::get_generation_reprioritize_distance);
+	ClassDB::bind_method(D_METHOD("set_generation_reprioritize_distance", "value"), &TerrainWorld::set_generation_reprioritize_distance);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "generation_reprioritize_distance"), "set_generation_reprioritize_distance", "get_generation_reprioritize_distance");
+
+	ClassDB::bind_method(D_METHOD("get_adaptive_generations"), &TerrainWorld::get_adaptive_generations);
+	ClassDB::bind_method(D_METHOD("set_adaptive_generations", "value"), &TerrainWorld::set_adaptive_generations);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "adaptive_generations"), "set_adaptive_generations", "get_adaptive_generations");
+
+	ClassDB::bind_method(D_METHOD("get_adaptive_generations_min"), &TerrainWorld::get_adaptive_generations_min);
+	ClassDB::bind_method(D_METHOD("set_adaptive_generations_min", "value"), &TerrainWorld::set_adaptive_generations_min);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "adaptive_generations_min"), "set_adaptive_generations_min", "get_adaptive_generations_min");
+
+	ClassDB::bind_method(D_METHOD("get_adaptive_generations_max"), &TerrainWorld::get_adaptive_generations_max);
+	ClassDB::bind_method(D_METHOD("set_adaptive_generations_max", "value"), &TerrainWorld::set_adaptive_generations_max);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "adaptive_generations_max"), "set_adaptive_generations_max", "get_adaptive_generations_max");
+
+	ClassDB::bind_method(D_METHOD("get_adaptive_generations_target_latency"), &TerrainWorld::get_adaptive_generations_target_latency);
+	ClassDB::bind_method(D_METHOD("set_adaptive_generations_target_latency", "value"), &TerrainWorld::set_adaptive_generations_target_latency);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "adaptive_generations_target_latency"), "set_adaptive_generations_target_latency", "get_adaptive_generations_target_latency");
+
+	ClassDB::bind_method(D_METHOD("get_adaptive_generations_interval"), &TerrainWorld::get_adaptive_generations_interval);
+	ClassDB::bind_method(D_METHOD("set_adaptive_generations_interval", "value"), &TerrainWorld::set_adaptive_generations_interval);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "adaptive_generations_interval"), "set_adaptive_generations_interval", "get_adaptive_generations_interval");
+
+	ClassDB::bind_method(D_METHOD("get_use_worker_threads"), &TerrainWorld::get_use_worker_threads);
+	ClassDB::bind_method(D_METHOD("set_use_worker_threads", "value"), &TerrainWorld::set_use_worker_threads);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_worker_threads"), "set_use_worker_threads", "get_use_worker_threads");
+
+	ClassDB::bind_method(D_METHOD("get_worker_thread_count"), &TerrainWorld::get_worker_thread_count);
+	ClassDB::bind_method(D_METHOD("set_worker_thread_count", "value"), &TerrainWorld::set_worker_thread_count);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "worker_thread_count"), "set_worker_thread_count", "get_worker_thread_count");
+
+	ClassDB::bind_method(D_METHOD("get_use_chunk_pool"), &TerrainWorld::get_use_chunk_pool);
+	ClassDB::bind_method(D_METHOD("set_use_chunk_pool", "value"), &TerrainWorld::set_use_chunk_pool);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_chunk_pool"), "set_use_chunk_pool", "get_use_chunk_pool");
+
+	ClassDB::bind_method(D_METHOD("get_chunk_pool_max_size"), &TerrainWorld::get_chunk_pool_max_size);
+	ClassDB::bind_method(D_METHOD("set_chunk_pool_max_size", "value"), &TerrainWorld::set_chunk_pool_max_size);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_pool_max_size"), "set_chunk_pool_max_size", "get_chunk_pool_max_size");
+
+	ClassDB::bind_method(D_METHOD("get_use_mesher_pool"), &TerrainWorld::get_use_mesher_pool);
+	ClassDB::bind_method(D_METHOD("set_use_mesher_pool", "value"), &TerrainWorld::set_use_mesher_pool);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_mesher_pool"), "set_use_mesher_pool", "get_use_mesher_pool");
+
+	ClassDB::bind_method(D_METHOD("get_headless_mode"), &TerrainWorld::get_headless_mode);
+	ClassDB::bind_method(D_METHOD("set_headless_mode", "value"), &TerrainWorld::set_headless_mode);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "headless_mode", PROPERTY_HINT_ENUM, BINDING_STRING_HEADLESS_MODE), "set_headless_mode", "get_headless_mode");
+
+	ClassDB::bind_method(D_METHOD("is_headless"), &TerrainWorld::is_headless);
+
+	ClassDB::bind_method(D_METHOD("worker_pool_start"), &TerrainWorld::worker_pool_start);
+	ClassDB::bind_method(D_METHOD("worker_pool_stop"), &TerrainWorld::worker_pool_stop);
+	ClassDB::bind_method(D_METHOD("worker_pool_is_running"), &TerrainWorld::worker_pool_is_running);
+
+	ClassDB::bind_method(D_METHOD("get_adaptive_generations_reason"), &TerrainWorld::get_adaptive_generations_reason);
+	ClassDB::bind_method(D_METHOD("get_generation_latency"), &TerrainWorld::get_generation_latency);
+	ClassDB::bind_method(D_METHOD("get_generation_worker_count"), &TerrainWorld::get_generation_worker_count);
+
+	ClassDB::bind_method(D_METHOD("get_max_frame_chunk_build_steps"), &TerrainWorld::get_max_frame_chunk_build_steps);
+	ClassDB::bind_method(D_METHOD("set_max_frame_chunk_build_steps", "value"), &TerrainWorld::set_max_frame_chunk_build_steps);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_frame_chunk_build_steps"), "set_max_frame_chunk_build_steps", "get_max_frame_chunk_build_steps");
+
+	ClassDB::bind_method(D_METHOD("get_process_build_budget_usec"), &TerrainWorld::get_process_build_budget_usec);
+	ClassDB::bind_method(D_METHOD("set_process_build_budget_usec", "value"), &TerrainWorld::set_process_build_budget_usec);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_build_budget_usec"), "set_process_build_budget_usec", "get_process_build_budget_usec");
+
+	ClassDB::bind_method(D_METHOD("get_physics_process_build_budget_usec"), &TerrainWorld::get_physics_process_build_budget_usec);
+	ClassDB::bind_method(D_METHOD("set_physics_process_build_budget_usec", "value"), &TerrainWorld::set_physics_process_build_budget_usec);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "physics_process_build_budget_usec"), "set_physics_process_build_budget_usec", "get_physics_process_build_budget_usec");
+
+	ClassDB::bind_method(D_METHOD("get_build_step_cost_smoothing"), &TerrainWorld::get_build_step_cost_smoothing);
+	ClassDB::bind_method(D_METHOD("set_build_step_cost_smoothing", "value"), &TerrainWorld::set_build_step_cost_smoothing);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "build_step_cost_smoothing"), "set_build_step_cost_smoothing", "get_build_step_cost_smoothing");
+
 	ClassDB::bind_method(D_METHOD("get_current_seed"), &TerrainWorld::get_current_seed);
 	ClassDB::bind_method(D_METHOD("set_current_seed", "value"), &TerrainWorld::set_current_seed);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "current_seed"), "set_current_seed", "get_current_seed");
@@ -1132,6 +3092,14 @@ void TerrainWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_voxel_scale", "value"), &TerrainWorld::set_voxel_scale);
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "voxel_scale"), "set_voxel_scale", "get_voxel_scale");
 
+	ClassDB::bind_method(D_METHOD("get_use_chunk_grid"), &TerrainWorld::get_use_chunk_grid);
+	ClassDB::bind_method(D_METHOD("set_use_chunk_grid", "value"), &TerrainWorld::set_use_chunk_grid);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_chunk_grid"), "set_use_chunk_grid", "get_use_chunk_grid");
+
+	ClassDB::bind_method(D_METHOD("get_chunk_grid_bounds"), &TerrainWorld::get_chunk_grid_bounds);
+	ClassDB::bind_method(D_METHOD("set_chunk_grid_bounds", "value"), &TerrainWorld::set_chunk_grid_bounds);
+	ADD_PROPERTY(PropertyInfo(Variant::RECT2, "chunk_grid_bounds"), "set_chunk_grid_bounds", "get_chunk_grid_bounds");
+
 	ClassDB::bind_method(D_METHOD("get_chunk_spawn_range"), &TerrainWorld::get_chunk_spawn_range);
 	ClassDB::bind_method(D_METHOD("set_chunk_spawn_range", "value"), &TerrainWorld::set_chunk_spawn_range);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_spawn_range"), "set_chunk_spawn_range", "get_chunk_spawn_range");
@@ -1144,6 +3112,71 @@ void TerrainWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_player", "player"), &TerrainWorld::set_player_bind);
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "player", PROPERTY_HINT_RESOURCE_TYPE, "Spatial", 0), "set_player", "get_player");
 
+	ClassDB::bind_method(D_METHOD("get_streaming"), &TerrainWorld::get_streaming);
+	ClassDB::bind_method(D_METHOD("set_streaming", "value"), &TerrainWorld::set_streaming);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "streaming"), "set_streaming", "get_streaming");
+
+	ClassDB::bind_method(D_METHOD("get_streaming_despawn_margin"), &TerrainWorld::get_streaming_despawn_margin);
+	ClassDB::bind_method(D_METHOD("set_streaming_despawn_margin", "value"), &TerrainWorld::set_streaming_despawn_margin);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "streaming_despawn_margin"), "set_streaming_despawn_margin", "get_streaming_despawn_margin");
+
+	ClassDB::bind_method(D_METHOD("streaming_ring_get_range", "ring"), &TerrainWorld::streaming_ring_get_range);
+	ClassDB::bind_method(D_METHOD("streaming_ring_set_range", "ring", "value"), &TerrainWorld::streaming_ring_set_range);
+	//the render ring's range is chunk_spawn_range
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_data_range"), "streaming_ring_set_range", "streaming_ring_get_range", STREAMING_RING_DATA);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_collider_range"), "streaming_ring_set_range", "streaming_ring_get_range", STREAMING_RING_COLLIDER);
+
+	ClassDB::bind_method(D_METHOD("streaming_ring_get_spawn_budget", "ring"), &TerrainWorld::streaming_ring_get_spawn_budget);
+	ClassDB::bind_method(D_METHOD("streaming_ring_set_spawn_budget", "ring", "value"), &TerrainWorld::streaming_ring_set_spawn_budget);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_data_spawn_budget"), "streaming_ring_set_spawn_budget", "streaming_ring_get_spawn_budget", STREAMING_RING_DATA);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_collider_spawn_budget"), "streaming_ring_set_spawn_budget", "streaming_ring_get_spawn_budget", STREAMING_RING_COLLIDER);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_render_spawn_budget"), "streaming_ring_set_spawn_budget", "streaming_ring_get_spawn_budget", STREAMING_RING_RENDER);
+
+	ClassDB::bind_method(D_METHOD("streaming_ring_get_despawn_budget", "ring"), &TerrainWorld::streaming_ring_get_despawn_budget);
+	ClassDB::bind_method(D_METHOD("streaming_ring_set_despawn_budget", "ring", "value"), &TerrainWorld::streaming_ring_set_despawn_budget);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_data_despawn_budget"), "streaming_ring_set_despawn_budget", "streaming_ring_get_despawn_budget", STREAMING_RING_DATA);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_collider_despawn_budget"), "streaming_ring_set_despawn_budget", "streaming_ring_get_despawn_budget", STREAMING_RING_COLLIDER);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "streaming_render_despawn_budget"), "streaming_ring_set_despawn_budget", "streaming_ring_get_despawn_budget", STREAMING_RING_RENDER);
+
+	ClassDB::bind_method(D_METHOD("streaming_get_chunk_flags", "x", "z"), &TerrainWorld::streaming_get_chunk_flags);
+	ClassDB::bind_method(D_METHOD("streaming_get_chunk_collider_lod_level", "x", "z"), &TerrainWorld::streaming_get_chunk_collider_lod_level);
+	ClassDB::bind_method(D_METHOD("streaming_invalidate"), &TerrainWorld::streaming_invalidate);
+	ClassDB::bind_method(D_METHOD("streaming_update"), &TerrainWorld::streaming_update);
+
+	ClassDB::bind_method(D_METHOD("get_collider_lod_range"), &TerrainWorld::get_collider_lod_range);
+	ClassDB::bind_method(D_METHOD("set_collider_lod_range", "value"), &TerrainWorld::set_collider_lod_range);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "collider_lod_range"), "set_collider_lod_range", "get_collider_lod_range");
+
+	ClassDB::bind_method(D_METHOD("get_collider_anchor_range"), &TerrainWorld::get_collider_anchor_range);
+	ClassDB::bind_method(D_METHOD("set_collider_anchor_range", "value"), &TerrainWorld::set_collider_anchor_range);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "collider_anchor_range"), "set_collider_anchor_range", "get_collider_anchor_range");
+
+	ClassDB::bind_method(D_METHOD("collider_anchor_add", "node"), &TerrainWorld::collider_anchor_add);
+	ClassDB::bind_method(D_METHOD("collider_anchor_remove", "node"), &TerrainWorld::collider_anchor_remove);
+	ClassDB::bind_method(D_METHOD("collider_anchor_get_count"), &TerrainWorld::collider_anchor_get_count);
+	ClassDB::bind_method(D_METHOD("collider_anchors_clear"), &TerrainWorld::collider_anchors_clear);
+	ClassDB::bind_method(D_METHOD("collider_anchor_is_near", "x", "z", "margin"), &TerrainWorld::collider_anchor_is_near, DEFVAL(0));
+
+	ClassDB::bind_method(D_METHOD("get_collider_region_size"), &TerrainWorld::get_collider_region_size);
+	ClassDB::bind_method(D_METHOD("set_collider_region_size", "value"), &TerrainWorld::set_collider_region_size);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "collider_region_size"), "set_collider_region_size", "get_collider_region_size");
+
+	ClassDB::bind_method(D_METHOD("collider_region_shape_add", "chunk_x", "chunk_z", "shape", "transform", "layer_mask"), &TerrainWorld::collider_region_shape_add, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("collider_region_shape_remove", "body", "shape"), &TerrainWorld::collider_region_shape_remove);
+	ClassDB::bind_method(D_METHOD("collider_region_shape_set_transform", "body", "shape", "transform"), &TerrainWorld::collider_region_shape_set_transform);
+	ClassDB::bind_method(D_METHOD("collider_region_get_count"), &TerrainWorld::collider_region_get_count);
+	ClassDB::bind_method(D_METHOD("collider_regions_clear"), &TerrainWorld::collider_regions_clear);
+
+	ClassDB::bind_method(D_METHOD("get_mesh_cache_path"), &TerrainWorld::get_mesh_cache_path);
+	ClassDB::bind_method(D_METHOD("set_mesh_cache_path", "value"), &TerrainWorld::set_mesh_cache_path);
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "mesh_cache_path", PROPERTY_HINT_DIR), "set_mesh_cache_path", "get_mesh_cache_path");
+
+	ClassDB::bind_method(D_METHOD("mesh_cache_is_enabled"), &TerrainWorld::mesh_cache_is_enabled);
+	ClassDB::bind_method(D_METHOD("mesh_cache_get_file_path", "key"), &TerrainWorld::mesh_cache_get_file_path);
+	ClassDB::bind_method(D_METHOD("mesh_cache_load", "key"), &TerrainWorld::mesh_cache_load);
+	ClassDB::bind_method(D_METHOD("mesh_cache_store", "key", "entry"), &TerrainWorld::mesh_cache_store);
+	ClassDB::bind_method(D_METHOD("mesh_cache_clear"), &TerrainWorld::mesh_cache_clear);
+
 	ClassDB::bind_method(D_METHOD("world_area_get", "index"), &TerrainWorld::world_area_get);
 	ClassDB::bind_method(D_METHOD("world_area_add", "area"), &TerrainWorld::world_area_add);
 	ClassDB::bind_method(D_METHOD("world_area_remove", "index"), &TerrainWorld::world_area_remove);
@@ -1176,6 +3209,7 @@ void TerrainWorld::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("chunk_get_index", "index"), &TerrainWorld::chunk_get_index);
 	ClassDB::bind_method(D_METHOD("chunk_get_count"), &TerrainWorld::chunk_get_count);
+	ClassDB::bind_method(D_METHOD("chunk_active_set_get_size", "set"), &TerrainWorld::chunk_active_set_get_size);
 
 	ClassDB::bind_method(D_METHOD("chunks_clear"), &TerrainWorld::chunks_clear);
 
@@ -1186,12 +3220,18 @@ void TerrainWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("generation_queue_add_to", "chunk"), &TerrainWorld::generation_queue_add_to);
 	ClassDB::bind_method(D_METHOD("generation_queue_get_index", "index"), &TerrainWorld::generation_queue_get_index);
 	ClassDB::bind_method(D_METHOD("generation_queue_remove_index", "index"), &TerrainWorld::generation_queue_remove_index);
+	ClassDB::bind_method(D_METHOD("generation_queue_remove", "chunk"), &TerrainWorld::generation_queue_remove);
 	ClassDB::bind_method(D_METHOD("generation_queue_get_size"), &TerrainWorld::generation_queue_get_size);
+	ClassDB::bind_method(D_METHOD("generation_queue_pop"), &TerrainWorld::generation_queue_pop);
+	ClassDB::bind_method(D_METHOD("generation_queue_get_priority", "chunk"), &TerrainWorld::generation_queue_get_priority);
+	ClassDB::bind_method(D_METHOD("generation_queue_update_viewer"), &TerrainWorld::generation_queue_update_viewer);
+	ClassDB::bind_method(D_METHOD("generation_queue_reprioritize"), &TerrainWorld::generation_queue_reprioritize);
 
 	ClassDB::bind_method(D_METHOD("generation_add_to", "chunk"), &TerrainWorld::generation_add_to);
 	ClassDB::bind_method(D_METHOD("generation_get_index", "index"), &TerrainWorld::generation_get_index);
 	ClassDB::bind_method(D_METHOD("generation_remove_index", "index"), &TerrainWorld::generation_remove_index);
 	ClassDB::bind_method(D_METHOD("generation_get_size"), &TerrainWorld::generation_get_size);
+	ClassDB::bind_method(D_METHOD("generation_adapt", "delta"), &TerrainWorld::generation_adapt);
 
 	ADD_SIGNAL(MethodInfo("generation_finished"));
 
@@ -1212,10 +3252,27 @@ void TerrainWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("chunk_create", "x", "z"), &TerrainWorld::chunk_create);
 	ClassDB::bind_method(D_METHOD("chunk_setup", "chunk"), &TerrainWorld::chunk_setup);
 
+	ClassDB::bind_method(D_METHOD("chunk_pool_add", "chunk"), &TerrainWorld::chunk_pool_add);
+	ClassDB::bind_method(D_METHOD("chunk_pool_pop"), &TerrainWorld::chunk_pool_pop);
+	ClassDB::bind_method(D_METHOD("chunk_pool_get_size"), &TerrainWorld::chunk_pool_get_size);
+	ClassDB::bind_method(D_METHOD("chunk_pool_clear"), &TerrainWorld::chunk_pool_clear);
+
+	ClassDB::bind_method(D_METHOD("mesher_pool_borrow", "settings"), &TerrainWorld::mesher_pool_borrow);
+	ClassDB::bind_method(D_METHOD("mesher_pool_return", "mesher"), &TerrainWorld::mesher_pool_return);
+	ClassDB::bind_method(D_METHOD("mesher_pool_get_size"), &TerrainWorld::mesher_pool_get_size);
+	ClassDB::bind_method(D_METHOD("mesher_pool_clear"), &TerrainWorld::mesher_pool_clear);
+	ClassDB::bind_method(D_METHOD("chunk_generate_data", "chunk"), &TerrainWorld::chunk_generate_data);
+	ClassDB::bind_method(D_METHOD("is_generation_thread_safe"), &TerrainWorld::is_generation_thread_safe);
+	ClassDB::bind_method(D_METHOD("pregenerate", "chunk_rect", "save_path", "thread_count"), &TerrainWorld::pregenerate, DEFVAL(""), DEFVAL(0));
+
 	ClassDB::bind_method(D_METHOD("_create_chunk", "x", "z", "chunk"), &TerrainWorld::_create_chunk);
 	ClassDB::bind_method(D_METHOD("_generate_chunk", "chunk"), &TerrainWorld::_generate_chunk);
 
 	ClassDB::bind_method(D_METHOD("can_chunk_do_build_step"), &TerrainWorld::can_chunk_do_build_step);
+	ClassDB::bind_method(D_METHOD("build_step_begin", "step", "physics"), &TerrainWorld::build_step_begin);
+	ClassDB::bind_method(D_METHOD("build_step_end", "step", "physics", "usec"), &TerrainWorld::build_step_end);
+	ClassDB::bind_method(D_METHOD("build_step_get_cost_estimate", "step"), &TerrainWorld::build_step_get_cost_estimate);
+	ClassDB::bind_method(D_METHOD("build_step_get_frame_used_usec", "physics"), &TerrainWorld::build_step_get_frame_used_usec);
 	ClassDB::bind_method(D_METHOD("is_position_walkable", "position"), &TerrainWorld::is_position_walkable);
 	ClassDB::bind_method(D_METHOD("on_chunk_mesh_generation_finished", "chunk"), &TerrainWorld::on_chunk_mesh_generation_finished);
 
@@ -1267,5 +3324,19 @@ void TerrainWorld::_bind_methods() {
 	BIND_ENUM_CONSTANT(CHANNEL_TYPE_INFO_ISOLEVEL);
 	BIND_ENUM_CONSTANT(CHANNEL_TYPE_INFO_LIQUID_FLOW);
 
+	BIND_ENUM_CONSTANT(STREAMING_RING_DATA);
+	BIND_ENUM_CONSTANT(STREAMING_RING_COLLIDER);
+	BIND_ENUM_CONSTANT(STREAMING_RING_RENDER);
+	BIND_ENUM_CONSTANT(STREAMING_RING_MAX);
+
+	BIND_ENUM_CONSTANT(CHUNK_ACTIVE_SET_PROCESS);
+	BIND_ENUM_CONSTANT(CHUNK_ACTIVE_SET_PHYSICS_PROCESS);
+	BIND_ENUM_CONSTANT(CHUNK_ACTIVE_SET_GENERATING);
+	BIND_ENUM_CONSTANT(CHUNK_ACTIVE_SET_MAX);
+
+	BIND_ENUM_CONSTANT(HEADLESS_MODE_AUTO);
+	BIND_ENUM_CONSTANT(HEADLESS_MODE_OFF);
+	BIND_ENUM_CONSTANT(HEADLESS_MODE_ON);
+
 	BIND_CONSTANT(NOTIFICATION_ACTIVE_STATE_CHANGED);
 }
@@ -41,6 +41,7 @@ SOFTWARE.
 #include "../level_generator/terrain_level_generator.h"
 #include "../library/terrain_library.h"
 
+#include "core/os/mutex.h"
 #include "core/os/os.h"
 
 #if PROPS_PRESENT
@@ -49,6 +50,9 @@ SOFTWARE.
 
 class TerrainStructure;
 class TerrainChunk;
+class TerrainJob;
+class TerrainMesher;
+class TerrainWorkerPool;
 class PropData;
 
 class TerrainWorld : public Navigation {
@@ -65,7 +69,33 @@ public:
 		NOTIFICATION_ACTIVE_STATE_CHANGED = 9000,
 	};
 
+	//data ring chunks only get their channels generated,
+	//the collider and render rings add colliders / meshes on top of that
+	enum StreamingRing {
+		STREAMING_RING_DATA = 0,
+		STREAMING_RING_COLLIDER,
+		STREAMING_RING_RENDER,
+		STREAMING_RING_MAX,
+	};
+
+	//chunks that need per frame calls, kept in sync by the chunks themselves
+	enum ChunkActiveSet {
+		CHUNK_ACTIVE_SET_PROCESS = 0,
+		CHUNK_ACTIVE_SET_PHYSICS_PROCESS,
+		CHUNK_ACTIVE_SET_GENERATING,
+		CHUNK_ACTIVE_SET_MAX,
+	};
+
+	//headless worlds only generate data and colliders, no meshes or library textures
+	enum HeadlessMode {
+		HEADLESS_MODE_AUTO = 0,
+		HEADLESS_MODE_OFF,
+		HEADLESS_MODE_ON,
+	};
+
 	static const String BINDING_STRING_CHANNEL_TYPE_INFO;
+	static const String BINDING_STRING_STREAMING_RING;
+	static const String BINDING_STRING_HEADLESS_MODE;
 
 public:
 	bool get_active() const;
@@ -92,9 +122,69 @@ public:
 	float get_world_height() const;
 	void set_world_height(const float value);
 
+	int get_palette_channels() const;
+	void set_palette_channels(const int value);
+
 	int get_max_concurrent_generations();
 	void set_max_concurrent_generations(const int value);
 
+	float get_generation_heading_bias() const;
+	void set_generation_heading_bias(const float value);
+
+	int get_generation_reprioritize_distance() const;
+	void set_generation_reprioritize_distance(const int value);
+
+	bool get_adaptive_generations() const;
+	void set_adaptive_generations(const bool value);
+
+	int get_adaptive_generations_min() const;
+	void set_adaptive_generations_min(const int value);
+
+	int get_adaptive_generations_max() const;
+	void set_adaptive_generations_max(const int value);
+
+	float get_adaptive_generations_target_latency() const;
+	void set_adaptive_generations_target_latency(const float value);
+
+	float get_adaptive_generations_interval() const;
+	void set_adaptive_generations_interval(const float value);
+
+	bool get_use_worker_threads() const;
+	void set_use_worker_threads(const bool value);
+
+	int get_worker_thread_count() const;
+	void set_worker_thread_count(const int value);
+
+	bool get_use_chunk_pool() const;
+	void set_use_chunk_pool(const bool value);
+
+	int get_chunk_pool_max_size() const;
+	void set_chunk_pool_max_size(const int value);
+
+	bool get_use_mesher_pool() const;
+	void set_use_mesher_pool(const bool value);
+
+	HeadlessMode get_headless_mode() const;
+	void set_headless_mode(const HeadlessMode value);
+
+	bool is_headless() const;
+
+	String get_adaptive_generations_reason() const;
+	float get_generation_latency() const;
+	int get_generation_worker_count() const;
+
+	int get_max_frame_chunk_build_steps() const;
+	void set_max_frame_chunk_build_steps(const int value);
+
+	int get_process_build_budget_usec() const;
+	void set_process_build_budget_usec(const int value);
+
+	int get_physics_process_build_budget_usec() const;
+	void set_physics_process_build_budget_usec(const int value);
+
+	float get_build_step_cost_smoothing() const;
+	void set_build_step_cost_smoothing(const float value);
+
 	Ref<TerrainLibrary> get_library();
 	void set_library(const Ref<TerrainLibrary> &library);
 
@@ -104,6 +194,13 @@ public:
 	float get_voxel_scale() const;
 	void set_voxel_scale(const float value);
 
+	//chunks inside the bounds are looked up from a flat array instead of the hashmap
+	bool get_use_chunk_grid() const;
+	void set_use_chunk_grid(const bool value);
+
+	Rect2 get_chunk_grid_bounds() const;
+	void set_chunk_grid_bounds(const Rect2 &value);
+
 	int get_chunk_spawn_range() const;
 	void set_chunk_spawn_range(const int value);
 
@@ -114,6 +211,61 @@ public:
 	void set_player(Spatial *player);
 	void set_player_bind(Node *player);
 
+	//Streaming
+	bool get_streaming() const;
+	void set_streaming(const bool value);
+
+	int get_streaming_despawn_margin() const;
+	void set_streaming_despawn_margin(const int value);
+
+	int streaming_ring_get_range(const int ring) const;
+	void streaming_ring_set_range(const int ring, const int value);
+
+	int streaming_ring_get_spawn_budget(const int ring) const;
+	void streaming_ring_set_spawn_budget(const int ring, const int value);
+
+	int streaming_ring_get_despawn_budget(const int ring) const;
+	void streaming_ring_set_despawn_budget(const int ring, const int value);
+
+	int streaming_get_chunk_flags(const int x, const int z) const;
+	int streaming_get_chunk_collider_lod_level(const int x, const int z) const;
+	void streaming_invalidate();
+	void streaming_update();
+
+	int get_collider_lod_range() const;
+	void set_collider_lod_range(const int value);
+
+	//Collider anchors
+	int get_collider_anchor_range() const;
+	void set_collider_anchor_range(const int value);
+
+	void collider_anchor_add(Node *node);
+	void collider_anchor_remove(Node *node);
+	int collider_anchor_get_count() const;
+	void collider_anchors_clear();
+	bool collider_anchor_is_near(const int x, const int z, const int margin = 0) const;
+
+	//Collider regions
+	int get_collider_region_size() const;
+	void set_collider_region_size(const int value);
+
+	RID collider_region_shape_add(const int chunk_x, const int chunk_z, const RID &shape, const Transform &transform, const int layer_mask = 1);
+	void collider_region_shape_remove(const RID &body, const RID &shape);
+	void collider_region_shape_set_transform(const RID &body, const RID &shape, const Transform &transform);
+	int collider_region_get_count() const;
+	void collider_regions_clear();
+
+	//Mesh cache
+	String get_mesh_cache_path() const;
+	void set_mesh_cache_path(const String &value);
+
+	bool mesh_cache_is_enabled() const;
+	String mesh_cache_get_file_path(const String &key) const;
+	Dictionary mesh_cache_load(const String &key) const;
+	void mesh_cache_store(const String &key, const Dictionary &entry);
+	void mesh_cache_clear();
+	static bool mesh_cache_is_valid_arrays(const Variant &arrays, const bool allow_empty);
+
 	//World Areas
 	Ref<TerrainWorldArea> world_area_get(const int index) const;
 	void world_area_add(const Ref<TerrainWorldArea> &area);
@@ -143,18 +295,42 @@ public:
 
 	int chunk_get_count() const;
 
+	void chunk_active_sets_update(TerrainChunk *chunk);
+	void chunk_active_sets_remove(TerrainChunk *chunk);
+	void chunk_active_sets_clear();
+	int chunk_active_set_get_size(const int set) const;
+
 	void chunks_clear();
 
 	Ref<TerrainChunk> chunk_get_or_create(const int x, const int z);
 	Ref<TerrainChunk> chunk_create(const int x, const int z);
 	void chunk_setup(Ref<TerrainChunk> chunk);
 
+	void chunk_pool_add(const Ref<TerrainChunk> &chunk);
+	Ref<TerrainChunk> chunk_pool_pop();
+	int chunk_pool_get_size() const;
+	void chunk_pool_clear();
+
+	Ref<TerrainMesher> mesher_pool_borrow(const Ref<TerrainMesher> &settings);
+	void mesher_pool_return(const Ref<TerrainMesher> &mesher);
+	int mesher_pool_get_size();
+	void mesher_pool_clear();
+
 	void chunk_generate(Ref<TerrainChunk> chunk);
+	void chunk_generate_data(Ref<TerrainChunk> chunk);
+	bool chunk_has_generate_job(const Ref<TerrainChunk> &chunk) const;
+	bool is_generation_thread_safe() const;
+
+	Error pregenerate(const Rect2 &chunk_rect, const String &save_path = "", const int thread_count = 0);
 
 	Vector<Variant> chunks_get();
 	void chunks_set(const Vector<Variant> &chunks);
 
 	bool can_chunk_do_build_step();
+	bool build_step_begin(const int step, const bool physics);
+	void build_step_end(const int step, const bool physics, const int usec);
+	float build_step_get_cost_estimate(const int step) const;
+	int build_step_get_frame_used_usec(const bool physics) const;
 	bool is_position_walkable(const Vector3 &p_pos);
 
 	void on_chunk_mesh_generation_finished(Ref<TerrainChunk> p_chunk);
@@ -162,12 +338,25 @@ public:
 	void generation_queue_add_to(const Ref<TerrainChunk> &chunk);
 	Ref<TerrainChunk> generation_queue_get_index(const int index);
 	void generation_queue_remove_index(const int index);
+	void generation_queue_remove(const Ref<TerrainChunk> &chunk);
 	int generation_queue_get_size() const;
+	Ref<TerrainChunk> generation_queue_pop();
+	float generation_queue_get_priority(const Ref<TerrainChunk> &chunk) const;
+	void generation_queue_update_viewer();
+	void generation_queue_reprioritize();
 
 	void generation_add_to(const Ref<TerrainChunk> &chunk);
 	Ref<TerrainChunk> generation_get_index(const int index);
 	void generation_remove_index(const int index);
 	int generation_get_size() const;
+	void generation_adapt(const float delta);
+
+	void worker_pool_start();
+	void worker_pool_stop();
+	bool worker_pool_is_running() const;
+	void worker_pool_add_job(const Ref<TerrainJob> &job);
+	bool worker_pool_has_job(const Ref<TerrainJob> &job);
+	bool worker_pool_cancel_job(const Ref<TerrainJob> &job);
 
 #if PROPS_PRESENT
 	void prop_add(Transform transform, const Ref<PropData> &prop, const bool apply_voxel_scale = true);
@@ -216,6 +405,10 @@ protected:
 	virtual Ref<TerrainChunk> _create_chunk(int x, int z, Ref<TerrainChunk> p_chunk);
 	virtual int _get_channel_index_info(const ChannelTypeInfo channel_type);
 	virtual void _set_voxel_with_tool(const bool mode_add, const Vector3 hit_position, const Vector3 hit_normal, const int selected_voxel, const int isolevel);
+	virtual void _pregenerate_chunk_lighting(Ref<TerrainChunk> chunk);
+
+	struct PregenerateData;
+	static void _pregenerate_thread_func(void *p_user_data);
 
 	virtual void _notification(int p_what);
 	static void _bind_methods();
@@ -223,7 +416,6 @@ protected:
 public:
 	struct IntPos {
 		int x;
-		int y;
 		int z;
 
 		IntPos() {
@@ -242,14 +434,100 @@ public:
 		}
 	};
 
+	//x times an odd constant plus z, positions only collide when they are billions of chunks apart,
+	//and neighbours stay in nearby buckets, which keeps lookups cache friendly (see tools/benchmark_chunk_lookup.cpp)
 	struct IntPosHasher {
 		static _FORCE_INLINE_ uint32_t hash(const IntPos &v) {
-			uint32_t hash = hash_djb2_one_32(v.x);
-			hash = hash_djb2_one_32(v.x, hash);
-			return hash_djb2_one_32(v.z, hash);
+			return static_cast<uint32_t>(v.x) * 0x9E3779B1u + static_cast<uint32_t>(v.z);
+		}
+	};
+
+	//closest first, same distances are ordered by angle, which gives a spiral
+	struct IntPosDistanceComparator {
+		_FORCE_INLINE_ bool operator()(const IntPos &a, const IntPos &b) const {
+			int da = a.x * a.x + a.z * a.z;
+			int db = b.x * b.x + b.z * b.z;
+
+			if (da != db) {
+				return da < db;
+			}
+
+			return Math::atan2(static_cast<float>(a.z), static_cast<float>(a.x)) < Math::atan2(static_cast<float>(b.z), static_cast<float>(b.x));
+		}
+	};
+
+protected:
+	//chunks add their shapes to one static body per region, the shape indices follow the shapes vector
+	struct ColliderRegion {
+		IntPos position;
+		RID body;
+		Vector<RID> shapes;
+	};
+
+	//the generation queue is a binary min heap on priority, order keeps it fifo for equal priorities
+	struct GenerationQueueEntry {
+		Ref<TerrainChunk> chunk;
+		float priority;
+		uint32_t order;
+
+		_FORCE_INLINE_ bool operator<(const GenerationQueueEntry &o) const {
+			if (priority != o.priority) {
+				return priority < o.priority;
+			}
+
+			return order < o.order;
+		}
+	};
+
+	void generation_queue_sift_up(int index);
+	void generation_queue_sift_down(int index);
+
+	_FORCE_INLINE_ int chunk_registry_get(const int x, const int z) const {
+		if (_use_chunk_grid) {
+			int gx = x - _chunk_grid_x;
+			int gz = z - _chunk_grid_z;
+
+			if (gx >= 0 && gz >= 0 && gx < _chunk_grid_size_x && gz < _chunk_grid_size_z) {
+				return _chunk_grid[gz * _chunk_grid_size_x + gx];
+			}
+		}
+
+		const int *index = _chunks.getptr(IntPos(x, z));
+
+		return index ? *index : -1;
+	}
+
+	void chunk_registry_add(const Ref<TerrainChunk> &chunk, const IntPos &pos);
+	void chunk_registry_remove(const Ref<TerrainChunk> &chunk);
+	void chunk_registry_set(const IntPos &pos, const int index);
+	void chunk_registry_rebuild();
+
+	struct StreamingRingData {
+		int range;
+		int spawn_budget;
+		int despawn_budget;
+
+		int spawn_cursor;
+		bool spawn_done;
+		Vector<IntPos> despawn_queue;
+
+		StreamingRingData() {
+			range = 0;
+			spawn_budget = 0;
+			despawn_budget = 0;
+			spawn_cursor = 0;
+			spawn_done = false;
 		}
 	};
 
+	int streaming_ring_get_effective_range(const int ring) const;
+	void streaming_collect_despawns();
+	void streaming_update_collider_lods();
+	void collider_anchors_update();
+	void streaming_ring_spawn(const int ring);
+	void chunk_active_set_toggle(TerrainChunk *chunk, const int set, const bool active);
+	void streaming_ring_despawn(const int ring);
+
 private:
 	bool _active;
 	bool _editable;
@@ -262,15 +540,23 @@ private:
 	int _data_margin_start;
 	int _data_margin_end;
 	float _world_height;
+	int _palette_channels;
 
 	Ref<TerrainLibrary> _library;
 	Ref<TerrainLevelGenerator> _level_generator;
 	float _voxel_scale;
-	int _chunk_spawn_range;
 
-	HashMap<IntPos, Ref<TerrainChunk>, IntPosHasher> _chunks;
+	//_chunks maps positions to indices in _chunks_vector, chunks store their own index
+	HashMap<IntPos, int, IntPosHasher> _chunks;
 	Vector<Ref<TerrainChunk>> _chunks_vector;
 
+	bool _use_chunk_grid;
+	int _chunk_grid_x;
+	int _chunk_grid_z;
+	int _chunk_grid_size_x;
+	int _chunk_grid_size_z;
+	Vector<int> _chunk_grid;
+
 	Vector<Ref<TerrainWorldArea>> _world_areas;
 
 	Vector<Ref<TerrainStructure>> _voxel_structures;
@@ -278,11 +564,72 @@ private:
 	NodePath _player_path;
 	Spatial *_player;
 
+	bool _streaming;
+	bool _streaming_dirty;
+	bool _streaming_has_center;
+	int _streaming_despawn_margin;
+	int _streaming_offsets_range;
+	IntPos _streaming_center;
+	StreamingRingData _streaming_rings[STREAMING_RING_MAX];
+	Vector<IntPos> _streaming_offsets;
+
+	int _collider_lod_range;
+	int _collider_anchor_range;
+	bool _collider_anchors_dirty;
+	Vector<ObjectID> _collider_anchors;
+	Vector<IntPos> _collider_anchor_positions;
+
+	int _collider_region_size;
+	Vector<ColliderRegion> _collider_regions;
+
+	String _mesh_cache_path;
+
 	int _max_concurrent_generations;
-	Vector<Ref<TerrainChunk>> _generation_queue;
+	Vector<GenerationQueueEntry> _generation_queue;
+	uint32_t _generation_queue_order;
+	float _generation_heading_bias;
+	int _generation_reprioritize_distance;
+	bool _generation_has_viewer;
+	Vector2 _generation_viewer_position;
+	Vector2 _generation_viewer_heading;
+	Vector2 _generation_queue_position;
+	Vector2 _generation_queue_heading;
 	Vector<Ref<TerrainChunk>> _generating;
+	Vector<uint64_t> _generating_start_usec;
+
+	Vector<TerrainChunk *> _chunk_active_sets[CHUNK_ACTIVE_SET_MAX];
+
+	bool _use_worker_threads;
+	int _worker_thread_count;
+	TerrainWorkerPool *_worker_pool;
+
+	bool _use_chunk_pool;
+	int _chunk_pool_max_size;
+	Vector<Ref<TerrainChunk>> _chunk_pool;
+
+	bool _use_mesher_pool;
+	Mutex _mesher_pool_mutex;
+	Vector<Ref<TerrainMesher>> _mesher_pool;
+
+	HeadlessMode _headless_mode;
+
+	bool _adaptive_generations;
+	int _adaptive_generations_min;
+	int _adaptive_generations_max;
+	float _adaptive_generations_target_latency;
+	float _adaptive_generations_interval;
+	float _adaptive_generations_timer;
+	String _adaptive_generations_reason;
+	float _generation_latency;
+	int _generation_completed;
 	int _max_frame_chunk_build_steps;
 	int _num_frame_chunk_build_steps;
+	int _process_build_budget_usec;
+	int _physics_process_build_budget_usec;
+	float _build_step_cost_smoothing;
+	uint64_t _frame_build_used_usec;
+	uint64_t _physics_frame_build_used_usec;
+	HashMap<int, float> _build_step_costs;
 
 	Vector<Ref<TerrainLight>> _lights;
 };
@@ -292,5 +639,8 @@ _FORCE_INLINE_ bool operator==(const TerrainWorld::IntPos &a, const TerrainWorld
 }
 
 VARIANT_ENUM_CAST(TerrainWorld::ChannelTypeInfo);
+VARIANT_ENUM_CAST(TerrainWorld::StreamingRing);
+VARIANT_ENUM_CAST(TerrainWorld::ChunkActiveSet);
+VARIANT_ENUM_CAST(TerrainWorld::HeadlessMode);
 
 #endif